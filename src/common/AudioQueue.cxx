@@ -17,17 +17,19 @@
 
 #include "AudioQueue.hxx"
 
-using std::mutex;
-using std::lock_guard;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::memory_order_relaxed;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioQueue::AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
   : myFragmentSize(fragmentSize),
     myIsStereo(isStereo),
     myFragmentQueue(capacity),
+    myCapacity(capacity),
     myAllFragments(capacity + 2),
-    mySize(0),
-    myNextFragment(0),
+    myHead(0),
+    myTail(0),
     myIgnoreOverflows(true)
 {
   const uInt8 sampleSize = myIsStereo ? 2 : 1;
@@ -47,15 +49,16 @@ AudioQueue::AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 AudioQueue::capacity() const
 {
-  return uInt32(myFragmentQueue.size());
+  return myCapacity;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 AudioQueue::size()
+uInt32 AudioQueue::size() const
 {
-  lock_guard<mutex> guard(myMutex);
+  const uInt32 head = myHead.load(memory_order_acquire);
+  const uInt32 tail = myTail.load(memory_order_acquire);
 
-  return mySize;
+  return tail >= head ? tail - head : tail + 2 * myCapacity - head;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -73,8 +76,6 @@ uInt32 AudioQueue::fragmentSize() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::enqueue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   Int16* newFragment;
 
   if (!fragment) {
@@ -86,27 +87,39 @@ Int16* AudioQueue::enqueue(Int16* fragment)
     return newFragment;
   }
 
-  const uInt8 capacity = uInt8(myFragmentQueue.size());
-  const uInt8 fragmentIndex = (myNextFragment + mySize) % capacity;
+  myStats.recordEnqueue();
+
+  const uInt32 tail = myTail.load(memory_order_relaxed);
+  const uInt32 head = myHead.load(memory_order_acquire);
 
-  newFragment = myFragmentQueue.at(fragmentIndex);
-  myFragmentQueue.at(fragmentIndex) = fragment;
+  // The queue is full -> drop the fragment, and fill it again
+  if (slot(tail) == slot(head) && tail != head) {
+    if (!myIgnoreOverflows.load(memory_order_relaxed))
+      myStats.recordOverflow();
 
-  if (mySize < capacity) ++mySize;
-  else {
-    myNextFragment = (myNextFragment + 1) % capacity;
-    if (!myIgnoreOverflows) (cerr << "audio buffer overflow\n").flush();
+    return fragment;
   }
 
+  // The consumer is done with this slot (it returned its fragment there)
+  newFragment = myFragmentQueue[slot(tail)];
+  myFragmentQueue[slot(tail)] = fragment;
+
+  // Hand over the slot to the consumer
+  myTail.store(nextIndex(tail), memory_order_release);
+
   return newFragment;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::dequeue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
+  const uInt32 head = myHead.load(memory_order_relaxed);
+  const uInt32 tail = myTail.load(memory_order_acquire);
+
+  // Records an underrun if the queue is empty
+  myStats.recordDequeue(tail >= head ? tail - head : tail + 2 * myCapacity - head);
 
-  if (mySize == 0) return nullptr;
+  if (head == tail) return nullptr;
 
   if (!fragment) {
     if (!myFirstFragmentForDequeue) throw runtime_error("dequeue called empty");
@@ -115,11 +128,11 @@ Int16* AudioQueue::dequeue(Int16* fragment)
     myFirstFragmentForDequeue = nullptr;
   }
 
-  Int16* nextFragment = myFragmentQueue.at(myNextFragment);
-  myFragmentQueue.at(myNextFragment) = fragment;
+  Int16* nextFragment = myFragmentQueue[slot(head)];
+  myFragmentQueue[slot(head)] = fragment;
 
-  --mySize;
-  myNextFragment = (myNextFragment + 1) % myFragmentQueue.size();
+  // Hand back the slot (now holding the played fragment) to the producer
+  myHead.store(nextIndex(head), memory_order_release);
 
   return nextFragment;
 }
@@ -127,8 +140,6 @@ Int16* AudioQueue::dequeue(Int16* fragment)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioQueue::closeSink(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   if (myFirstFragmentForDequeue && fragment)
     throw new runtime_error("attempt to return unknown buffer on closeSink");
 
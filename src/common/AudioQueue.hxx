@@ -18,9 +18,10 @@
 #ifndef AUDIO_QUEUE_HXX
 #define AUDIO_QUEUE_HXX
 
-#include <mutex>
+#include <atomic>
 
 #include "bspf.hxx"
+#include "AudioStats.hxx"
 
 /**
   This class implements a an audio queue that acts both like a ring buffer
@@ -32,6 +33,14 @@
   The queue needs to be threadsafe as the (SDL) audio driver runs on a
   separate thread. Samples are stored as signed 16 bit integers
   (platform endian).
+
+  The queue is lock-free, as there is exactly one producer (the emulation,
+  calling enqueue) and one consumer (the audio driver, calling dequeue
+  and closeSink), so the real time audio thread can never block on the
+  emulation. Each slot of the ring holds one fragment; the producer only
+  touches the slot at the tail and the consumer the one at the head, and
+  ownership of a slot is handed over by advancing the (atomic) index.
+  When the queue is full, the newly enqueued fragment is dropped.
 */
 class AudioQueue
 {
@@ -54,7 +63,7 @@ class AudioQueue
     /**
       Size getter.
      */
-    uInt32 size();
+    uInt32 size() const;
 
     /**
       Stereo / mono getter.
@@ -95,6 +104,40 @@ class AudioQueue
      */
     void ignoreOverflows(bool shouldIgnoreOverflows);
 
+    /**
+      The number of fragments dropped because the queue was full (unless
+      overflows were ignored).
+     */
+    uInt64 overflows() const { return myStats.overflows(); }
+
+    /**
+      The number of dequeue calls which found the queue empty.
+     */
+    uInt64 underruns() const { return myStats.underruns(); }
+
+    /**
+      The statistics of the audio pipeline using this queue.
+     */
+    AudioStats& stats() { return myStats; }
+    const AudioStats& stats() const { return myStats; }
+
+  private:
+
+    /**
+      Advance a ring index, which runs from 0 to 2 * capacity - 1 (so that
+      a full and an empty queue can be told apart).
+     */
+    uInt32 nextIndex(uInt32 index) const {
+      return index + 1 == 2 * myCapacity ? 0 : index + 1;
+    }
+
+    /**
+      The slot of the ring for the given index.
+     */
+    uInt32 slot(uInt32 index) const {
+      return index >= myCapacity ? index - myCapacity : index;
+    }
+
   private:
 
     // The size of an individual fragment (in stereo / mono samples)
@@ -106,28 +149,31 @@ class AudioQueue
     // The fragment queue
     vector<Int16*> myFragmentQueue;
 
+    // The number of slots in the queue
+    uInt32 myCapacity;
+
     // All fragments, including the two fragments that are in circulation.
     vector<Int16*> myAllFragments;
 
     // We allocate a consecutive slice of memory for the fragments.
     unique_ptr<Int16[]> myFragmentBuffer;
 
-    // The nubmer if queued fragments
-    uInt32 mySize;
+    // Index of the next fragment to dequeue (written by the consumer only)
+    std::atomic<uInt32> myHead;
 
-    // The next fragment.
-    uInt32 myNextFragment;
-
-    // We need a mutex for thread safety.
-    std::mutex myMutex;
+    // Index of the next fragment to enqueue (written by the producer only)
+    std::atomic<uInt32> myTail;
 
     // The first (empty) enqueue call returns this fragment.
     Int16* myFirstFragmentForEnqueue;
     // The first (empty) dequeue call replaces the returned fragment with this fragment.
     Int16* myFirstFragmentForDequeue;
 
-    // Log overflows?
-    bool myIgnoreOverflows;
+    // Count overflows?
+    std::atomic<bool> myIgnoreOverflows;
+
+    // Overflow and underrun counters, and further statistics
+    AudioStats myStats;
 
   private:
 
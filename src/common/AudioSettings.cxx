@@ -28,7 +28,7 @@ namespace {
   {
     return (
       numericPreset >= static_cast<int>(AudioSettings::Preset::custom) &&
-      numericPreset <= static_cast<int>(AudioSettings::Preset::veryHighQualityVeryLowLag)
+      numericPreset <= static_cast<int>(AudioSettings::Preset::lowLatency)
     ) ? static_cast<AudioSettings::Preset>(numericPreset) : AudioSettings::DEFAULT_PRESET;
   }
 
@@ -36,7 +36,7 @@ namespace {
   {
     return (
       numericResamplingQuality >= static_cast<int>(AudioSettings::ResamplingQuality::nearestNeightbour) &&
-      numericResamplingQuality <= static_cast<int>(AudioSettings::ResamplingQuality::lanczos_3)
+      numericResamplingQuality <= static_cast<int>(AudioSettings::ResamplingQuality::blep)
     ) ? static_cast<AudioSettings::ResamplingQuality>(numericResamplingQuality) : AudioSettings::DEFAULT_RESAMPLING_QUALITY;
   }
 }
@@ -140,6 +140,13 @@ AudioSettings::ResamplingQuality AudioSettings::resamplingQuality()
   return customSettings() ? normalizeResamplingQuality(mySettings.getInt(SETTING_RESAMPLING_QUALITY)) : myPresetResamplingQuality;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool AudioSettings::dynamicRate()
+{
+  updatePresetFromSettings();
+  return customSettings() ? mySettings.getBool(SETTING_DYNAMIC_RATE) : myPresetDynamicRate;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string AudioSettings::stereo() const
 {
@@ -176,6 +183,7 @@ void AudioSettings::setPreset(AudioSettings::Preset preset)
       myPresetBufferSize = 6;
       myPresetHeadroom = 5;
       myPresetResamplingQuality = ResamplingQuality::nearestNeightbour;
+      myPresetDynamicRate = false;
       break;
 
     case Preset::highQualityMediumLag:
@@ -184,6 +192,7 @@ void AudioSettings::setPreset(AudioSettings::Preset preset)
       myPresetBufferSize = 6;
       myPresetHeadroom = 5;
       myPresetResamplingQuality = ResamplingQuality::lanczos_2;
+      myPresetDynamicRate = false;
       break;
 
     case Preset::highQualityLowLag:
@@ -192,6 +201,7 @@ void AudioSettings::setPreset(AudioSettings::Preset preset)
       myPresetBufferSize = 3;
       myPresetHeadroom = 2;
       myPresetResamplingQuality = ResamplingQuality::lanczos_2;
+      myPresetDynamicRate = false;
       break;
 
     case Preset::veryHighQualityVeryLowLag:
@@ -200,6 +210,16 @@ void AudioSettings::setPreset(AudioSettings::Preset preset)
       myPresetBufferSize = 0;
       myPresetHeadroom = 0;
       myPresetResamplingQuality = ResamplingQuality::lanczos_3;
+      myPresetDynamicRate = false;
+      break;
+
+    case Preset::lowLatency:
+      myPresetSampleRate = 48000;
+      myPresetFragmentSize = 256;
+      myPresetBufferSize = 1;
+      myPresetHeadroom = 1;
+      myPresetResamplingQuality = ResamplingQuality::lanczos_2;
+      myPresetDynamicRate = true;
       break;
 
     default:
@@ -254,6 +274,14 @@ void AudioSettings::setResamplingQuality(AudioSettings::ResamplingQuality resamp
   normalize(mySettings);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioSettings::setDynamicRate(bool isEnabled)
+{
+  if (!myIsPersistent) return;
+
+  mySettings.setValue(SETTING_DYNAMIC_RATE, isEnabled);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioSettings::setStereo(const string& mode)
 {
@@ -31,13 +31,15 @@ class AudioSettings
       lowQualityMediumLag       = 2,
       highQualityMediumLag      = 3,
       highQualityLowLag         = 4,
-      veryHighQualityVeryLowLag = 5
+      veryHighQualityVeryLowLag = 5,
+      lowLatency                = 6
     };
 
     enum class ResamplingQuality {
       nearestNeightbour   = 1,
       lanczos_2           = 2,
-      lanczos_3           = 3
+      lanczos_3           = 3,
+      blep                = 4
     };
 
     static constexpr const char* SETTING_PRESET              = "audio.preset";
@@ -46,6 +48,8 @@ class AudioSettings
     static constexpr const char* SETTING_BUFFER_SIZE         = "audio.buffer_size";
     static constexpr const char* SETTING_HEADROOM            = "audio.headroom";
     static constexpr const char* SETTING_RESAMPLING_QUALITY  = "audio.resampling_quality";
+    static constexpr const char* SETTING_DYNAMIC_RATE        = "audio.dynamic_rate";
+    static constexpr const char* SETTING_STATS               = "audio.stats";
     static constexpr const char* SETTING_STEREO              = "audio.stereo";
     static constexpr const char* SETTING_VOLUME              = "audio.volume";
     static constexpr const char* SETTING_ENABLED             = "audio.enabled";
@@ -56,6 +60,8 @@ class AudioSettings
     static constexpr uInt32 DEFAULT_BUFFER_SIZE                     = 3;
     static constexpr uInt32 DEFAULT_HEADROOM                        = 2;
     static constexpr ResamplingQuality DEFAULT_RESAMPLING_QUALITY   = ResamplingQuality::lanczos_2;
+    static constexpr bool DEFAULT_DYNAMIC_RATE                      = false;
+    static constexpr uInt32 DEFAULT_STATS                           = 0;
     static constexpr const char* DEFAULT_STEREO                     = "byrom";
     static constexpr uInt32 DEFAULT_VOLUME                          = 80;
     static constexpr bool DEFAULT_ENABLED                           = true;
@@ -81,6 +87,8 @@ class AudioSettings
 
     ResamplingQuality resamplingQuality();
 
+    bool dynamicRate();
+
     string stereo() const;
 
     uInt32 volume() const;
@@ -99,6 +107,8 @@ class AudioSettings
 
     void setResamplingQuality(ResamplingQuality resamplingQuality);
 
+    void setDynamicRate(bool isEnabled);
+
     void setStereo(const string& mode);
 
     void setVolume(uInt32 volume);
@@ -124,6 +134,7 @@ class AudioSettings
     uInt32 myPresetBufferSize;
     uInt32 myPresetHeadroom;
     ResamplingQuality myPresetResamplingQuality;
+    bool myPresetDynamicRate;
 
     bool myIsPersistent;
 };
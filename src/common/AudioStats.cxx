@@ -0,0 +1,225 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <sstream>
+
+#include "AudioStats.hxx"
+
+using std::memory_order_relaxed;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+namespace {
+  uInt32 timeBucket(uInt64 micros)
+  {
+    uInt32 bucket = 0;
+    while (micros > 0 && bucket < AudioStats::TIME_BUCKETS - 1) {
+      micros >>= 1;
+      ++bucket;
+    }
+
+    return bucket;
+  }
+
+  template<uInt32 n>
+  uInt32 percentileBucket(const uInt64 (&buckets)[n], double fraction)
+  {
+    uInt64 total = 0;
+    for (uInt32 i = 0; i < n; ++i) total += buckets[i];
+
+    const uInt64 limit = static_cast<uInt64>(fraction * total);
+    uInt64 count = 0;
+
+    for (uInt32 i = 0; i < n; ++i) {
+      count += buckets[i];
+      if (count > limit) return i;
+    }
+
+    return n - 1;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioStats::Snapshot::Snapshot()
+  : overflows(0),
+    underruns(0)
+{
+  memset(fill, 0, sizeof(fill));
+  memset(time, 0, sizeof(time));
+  memset(timeSum, 0, sizeof(timeSum));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioStats::Snapshot AudioStats::Snapshot::operator-(const Snapshot& other) const
+{
+  Snapshot result;
+
+  result.overflows = overflows - other.overflows;
+  result.underruns = underruns - other.underruns;
+
+  for (uInt32 i = 0; i < FILL_BUCKETS; ++i)
+    result.fill[i] = fill[i] - other.fill[i];
+
+  for (uInt32 t = 0; t < TIMINGS; ++t) {
+    for (uInt32 i = 0; i < TIME_BUCKETS; ++i)
+      result.time[t][i] = time[t][i] - other.time[t][i];
+
+    result.timeSum[t] = timeSum[t] - other.timeSum[t];
+  }
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 AudioStats::Snapshot::dequeues() const
+{
+  uInt64 count = 0;
+  for (uInt32 i = 0; i < FILL_BUCKETS; ++i) count += fill[i];
+
+  return count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double AudioStats::Snapshot::meanFill() const
+{
+  uInt64 count = 0, sum = 0;
+  for (uInt32 i = 0; i < FILL_BUCKETS; ++i) {
+    count += fill[i];
+    sum += fill[i] * i;
+  }
+
+  return count > 0 ? static_cast<double>(sum) / count : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioStats::Snapshot::fillPercentile(double fraction) const
+{
+  return percentileBucket(fill, fraction);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double AudioStats::Snapshot::meanTime(Timing timing) const
+{
+  const uInt32 t = static_cast<uInt32>(timing);
+
+  uInt64 count = 0;
+  for (uInt32 i = 0; i < TIME_BUCKETS; ++i) count += time[t][i];
+
+  return count > 0 ? static_cast<double>(timeSum[t]) / count : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 AudioStats::Snapshot::timePercentile(Timing timing, double fraction) const
+{
+  const uInt32 bucket = percentileBucket(time[static_cast<uInt32>(timing)], fraction);
+
+  return bucket > 0 ? (uInt64(1) << bucket) - 1 : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string AudioStats::Snapshot::summary() const
+{
+  std::ostringstream buf;
+
+  buf << std::fixed << std::setprecision(1)
+      << "queue " << meanFill()
+      << " [" << fillPercentile(0.01) << ".." << fillPercentile(0.99) << "] fragments, "
+      << underruns << " underruns, " << overflows << " overflows, "
+      << std::setprecision(0)
+      << "callback " << meanTime(Timing::callback)
+      << "us (p99 " << timePercentile(Timing::callback, 0.99) << "us), "
+      << "resampling " << meanTime(Timing::resampling)
+      << "us (p99 " << timePercentile(Timing::resampling, 0.99) << "us), "
+      << std::setprecision(1)
+      << "enqueue interval " << meanTime(Timing::enqueueInterval) / 1000
+      << "ms (p99 " << timePercentile(Timing::enqueueInterval, 0.99) / 1000. << "ms)";
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioStats::AudioStats()
+  : myOverflows(0),
+    myUnderruns(0),
+    myHasEnqueued(false)
+{
+  for (uInt32 i = 0; i < FILL_BUCKETS; ++i) myFill[i] = 0;
+
+  for (uInt32 t = 0; t < TIMINGS; ++t) {
+    for (uInt32 i = 0; i < TIME_BUCKETS; ++i) myTime[t][i] = 0;
+
+    myTimeSum[t] = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioStats::recordEnqueue()
+{
+  const steady_clock::time_point now = steady_clock::now();
+
+  if (myHasEnqueued)
+    recordTime(Timing::enqueueInterval, duration_cast<microseconds>(now - myLastEnqueue).count());
+
+  myLastEnqueue = now;
+  myHasEnqueued = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioStats::recordOverflow()
+{
+  myOverflows.fetch_add(1, memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioStats::recordDequeue(uInt32 fill)
+{
+  myFill[std::min(fill, FILL_BUCKETS - 1)].fetch_add(1, memory_order_relaxed);
+
+  if (fill == 0) myUnderruns.fetch_add(1, memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioStats::recordTime(Timing timing, uInt64 micros)
+{
+  const uInt32 t = static_cast<uInt32>(timing);
+
+  myTime[t][timeBucket(micros)].fetch_add(1, memory_order_relaxed);
+  myTimeSum[t].fetch_add(micros, memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioStats::Snapshot AudioStats::snapshot() const
+{
+  Snapshot snapshot;
+
+  snapshot.overflows = myOverflows.load(memory_order_relaxed);
+  snapshot.underruns = myUnderruns.load(memory_order_relaxed);
+
+  for (uInt32 i = 0; i < FILL_BUCKETS; ++i)
+    snapshot.fill[i] = myFill[i].load(memory_order_relaxed);
+
+  for (uInt32 t = 0; t < TIMINGS; ++t) {
+    for (uInt32 i = 0; i < TIME_BUCKETS; ++i)
+      snapshot.time[t][i] = myTime[t][i].load(memory_order_relaxed);
+
+    snapshot.timeSum[t] = myTimeSum[t].load(memory_order_relaxed);
+  }
+
+  return snapshot;
+}
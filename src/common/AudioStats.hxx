@@ -0,0 +1,170 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef AUDIO_STATS_HXX
+#define AUDIO_STATS_HXX
+
+#include <atomic>
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  Counters and histograms describing the audio pipeline: the fill level of
+  the audio queue whenever the sound driver asks for a fragment, underruns
+  and overflows, the duration of the sound driver callback and of the
+  resampling within it, and the time between two fragments enqueued by the
+  emulation.
+
+  Each value is recorded by exactly one thread (the emulation for enqueues
+  and overflows, the sound driver for everything else), and may be read
+  from any thread through snapshot().  The counters only ever increase;
+  the statistics for a period of time are the difference of two snapshots.
+*/
+class AudioStats
+{
+  public:
+
+    // The timings which are recorded
+    enum class Timing { enqueueInterval = 0, callback = 1, resampling = 2 };
+    static constexpr uInt32 TIMINGS = 3;
+
+    // The fill level histogram has one bucket per fragment (the last one
+    // includes all higher levels), the timing histograms have logarithmic
+    // buckets: bucket n > 0 holds durations of 2^(n-1) .. 2^n - 1 us
+    static constexpr uInt32 FILL_BUCKETS = 16;
+    static constexpr uInt32 TIME_BUCKETS = 28;
+
+    class Snapshot {
+      public:
+
+        Snapshot();
+
+        /**
+          The statistics of the period between the given (older) snapshot
+          and this one.
+         */
+        Snapshot operator-(const Snapshot& other) const;
+
+        /**
+          The number of fragments requested by the sound driver.
+         */
+        uInt64 dequeues() const;
+
+        /**
+          The average fill level of the queue (in fragments) when the
+          sound driver asked for a fragment.
+         */
+        double meanFill() const;
+
+        /**
+          The fill level which is not exceeded in the given fraction of all
+          requests of the sound driver.
+         */
+        uInt32 fillPercentile(double fraction) const;
+
+        /**
+          The average of the given timing (in microseconds).
+         */
+        double meanTime(Timing timing) const;
+
+        /**
+          The (upper bound of the) time which is not exceeded in the given
+          fraction of all measurements (in microseconds).
+         */
+        uInt64 timePercentile(Timing timing, double fraction) const;
+
+        /**
+          A one line summary for logging.
+         */
+        string summary() const;
+
+      public:
+
+        uInt64 overflows;
+        uInt64 underruns;
+
+        uInt64 fill[FILL_BUCKETS];
+
+        uInt64 time[TIMINGS][TIME_BUCKETS];
+        uInt64 timeSum[TIMINGS];
+    };
+
+  public:
+
+    AudioStats();
+
+    /**
+      Record a fragment enqueued by the emulation (measuring the time since
+      the last one).
+     */
+    void recordEnqueue();
+
+    /**
+      Record a fragment dropped because the queue was full.
+     */
+    void recordOverflow();
+
+    /**
+      Record a fragment requested by the sound driver.
+
+      @param fill  The number of queued fragments (0 is an underrun)
+     */
+    void recordDequeue(uInt32 fill);
+
+    /**
+      Record a duration.
+
+      @param timing  The timing which was measured
+      @param micros  The duration (in microseconds)
+     */
+    void recordTime(Timing timing, uInt64 micros);
+
+    /**
+      Read the current values of all counters.
+     */
+    Snapshot snapshot() const;
+
+    uInt64 overflows() const { return myOverflows.load(std::memory_order_relaxed); }
+    uInt64 underruns() const { return myUnderruns.load(std::memory_order_relaxed); }
+
+  private:
+
+    using Counter = std::atomic<uInt64>;
+
+    Counter myOverflows;
+    Counter myUnderruns;
+
+    Counter myFill[FILL_BUCKETS];
+
+    Counter myTime[TIMINGS][TIME_BUCKETS];
+    Counter myTimeSum[TIMINGS];
+
+    // Time of the last enqueue (only accessed by the emulation)
+    std::chrono::steady_clock::time_point myLastEnqueue;
+    bool myHasEnqueued;
+
+  private:
+
+    AudioStats(const AudioStats&) = delete;
+    AudioStats(AudioStats&&) = delete;
+    AudioStats& operator=(const AudioStats&) = delete;
+    AudioStats& operator=(AudioStats&&) = delete;
+};
+
+#endif // AUDIO_STATS_HXX
@@ -18,21 +18,28 @@
 #ifndef LINKED_OBJECT_POOL_HXX
 #define LINKED_OBJECT_POOL_HXX
 
-#include <list>
+#include <iterator>
 #include "bspf.hxx"
 
 /**
-  A fixed-size object-pool based doubly-linked list that makes use of
-  multiple STL lists, to reduce frequent (de)allocations.
+  An object-pool based list that avoids frequent (de)allocations.
 
   This structure can be used as either a stack or queue, but also allows
   for removal at any location in the list.
 
-  There are two internal lists; one stores active nodes, and the other
-  stores pool nodes that have been 'deleted' from the active list (note
-  that no actual deletion takes place; nodes are simply moved from one list
-  to another).  Similarly, when a new node is added to the active list, it
-  is simply moved from the pool list to the active list.
+  All nodes are allocated in chunks, and stay at the same address until the
+  pool is resized (so pointers to node data remain valid, even when the pool
+  grows).  The order of the nodes is kept in a ring buffer of node pointers;
+  the active list
+  occupies a contiguous range of the ring, starting at 'myHead', and the
+  remaining entries are the unused (pool) nodes.  Adding and removing nodes
+  at either end simply moves the boundaries of that range; removing a node
+  in the middle moves the shorter part of the range by one entry.
+
+  As such, the position of a node in the active list is always known, and
+  any node can be accessed by its position in constant time.  Iterators
+  are simply positions in the active list; they're invalidated by adding or
+  removing nodes in front of them.
 
   In all cases, the variable 'myCurrent' is updated to point to the
   current node.
@@ -40,11 +47,6 @@
   NOTE: You must always call 'currentIsValid()' before calling 'current()',
         to make sure that the return value is a valid reference.
 
-        In the case of methods which wrap the C++ 'splice()' method, the
-        semantics of splice are followed wrt invalid/out-of-range/etc
-        iterators.  See the applicable C++ STL documentation for such
-        behaviour.
-
   @author Stephen Anthony
 */
 namespace Common {
@@ -53,13 +55,48 @@ template <class T, uInt32 CAPACITY = 100>
 class LinkedObjectPool
 {
   public:
-    using iter = typename std::list<T>::iterator;
-    using const_iter = typename std::list<T>::const_iterator;
+    /**
+      Iterator over the active list; it simply holds the position of
+      the node in the list.
+    */
+    class const_iter
+    {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = Int32;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iter() : myPool(nullptr), myIdx(0) { }
+        const_iter(const LinkedObjectPool* pool, uInt32 idx) : myPool(pool), myIdx(idx) { }
+
+        const T& operator*() const  { return myPool->node(myIdx); }
+        const T* operator->() const { return &myPool->node(myIdx); }
+
+        const_iter& operator++()   { ++myIdx;  return *this; }
+        const_iter& operator--()   { --myIdx;  return *this; }
+        const_iter operator++(int) { const_iter i = *this;  ++myIdx;  return i; }
+        const_iter operator--(int) { const_iter i = *this;  --myIdx;  return i; }
+
+        bool operator==(const const_iter& i) const { return myIdx == i.myIdx; }
+        bool operator!=(const const_iter& i) const { return myIdx != i.myIdx; }
+
+        /**
+          The position of the node in the active list (0 = first node).
+        */
+        uInt32 index() const { return myIdx; }
+
+      private:
+        const LinkedObjectPool* myPool;
+        uInt32 myIdx;
+    };
 
     /*
       Create a pool of size CAPACITY; the active list starts out empty.
     */
-    LinkedObjectPool<T, CAPACITY>() : myCurrent(myList.end()), myCapacity(0) {
+    LinkedObjectPool<T, CAPACITY>()
+      : myHead(0), mySize(0), myCurrent(0), myCapacity(0) {
       resize(CAPACITY);
     }
 
@@ -70,29 +107,37 @@ class LinkedObjectPool
 
       Make sure to call 'currentIsValid()' before accessing this method.
     */
-    T& current() const { return *myCurrent; }
+    T& current() const { return node(myCurrent); }
 
     /**
-      Returns current's position in the list
+      Return an iterator to the 'current' node.  Make sure to call
+      'currentIsValid()' before using it.
+    */
+    const_iter currentIter() const { return const_iter(this, myCurrent); }
 
-      SLOW, but only required for messages
+    /**
+      Return (modifiable) node data at the given iterator.
     */
-    uInt32 currentIdx() const {
-      if(empty())
-        return 0;
+    T& at(const_iter i) { return node(i.index()); }
 
-      iter it = myCurrent;
-      uInt32 idx = 1;
+    /**
+      Return an iterator to the node at the given position in the active
+      list (0 = first node).
+    */
+    const_iter iterAt(uInt32 idx) const { return const_iter(this, idx); }
 
-      while(it-- != myList.begin()) ++idx;
-      return idx;
+    /**
+      Returns current's position in the list (1 = first node, 0 = empty)
+    */
+    uInt32 currentIdx() const {
+      return empty() ? 0 : myCurrent + 1;
     }
 
     /**
       Does the 'current' iterator point to a valid node in the active list?
       This must be called before 'current()' is called.
     */
-    bool currentIsValid() const { return myCurrent != myList.end(); }
+    bool currentIsValid() const { return myCurrent < mySize; }
 
     /**
       Advance 'current' iterator to previous position in the active list.
@@ -100,7 +145,7 @@ class LinkedObjectPool
     */
     void moveToPrevious() {
       if(currentIsValid())
-        myCurrent = myCurrent == myList.begin() ? myList.end() : std::prev(myCurrent, 1);
+        myCurrent = myCurrent == 0 ? mySize : myCurrent - 1;
     }
 
     /**
@@ -109,48 +154,74 @@ class LinkedObjectPool
     */
     void moveToNext() {
       if(currentIsValid())
-        myCurrent = std::next(myCurrent, 1);
+        ++myCurrent;
     }
 
+    /**
+      Move 'current' iterator to the given iterator.
+    */
+    void moveTo(const_iter i) { myCurrent = i.index(); }
+
     /**
       Return an iterator to the first node in the active list.
     */
-    const_iter first() const { return myList.begin(); }
+    const_iter first() const { return const_iter(this, 0); }
 
     /**
       Return an iterator to the last node in the active list.
     */
-    const_iter last() const { return std::prev(myList.end(), 1); }
+    const_iter last() const { return const_iter(this, mySize - 1); }
 
     /**
       Return an iterator to the previous node of 'i' in the active list.
     */
-    const_iter previous(const_iter i) const { return std::prev(i, 1); }
+    const_iter previous(const_iter i) const { return --i; }
 
     /**
       Return an iterator to the next node to 'current' in the active list.
     */
-    const_iter next(const_iter i) const { return std::next(i, 1); }
+    const_iter next(const_iter i) const { return ++i; }
 
     /**
       Canonical iterators from C++ STL.
     */
-    const_iter cbegin() const { return myList.cbegin(); }
-    const_iter cend() const   { return myList.cend();   }
+    const_iter cbegin() const { return const_iter(this, 0); }
+    const_iter cend() const   { return const_iter(this, mySize); }
 
     /**
       Answer whether 'current' is at the specified iterator.
     */
-    bool atFirst() const { return myCurrent == first(); }
-    bool atLast() const  { return myCurrent == last();  }
+    bool atFirst() const { return myCurrent == 0; }
+    bool atLast() const  { return myCurrent + 1 == mySize; }
+
+    /**
+      Return an iterator to the first node for which 'less(value, node)' is
+      true (or cend(), if there is none), using a binary search.  The nodes
+      must be sorted wrt 'less'.
+    */
+    template <class V, class Less>
+    const_iter upperBound(const V& value, Less less) const {
+      uInt32 lo = 0, hi = mySize;
+      while(lo < hi)
+      {
+        const uInt32 mid = lo + (hi - lo) / 2;
+        if(less(value, node(mid)))
+          hi = mid;
+        else
+          lo = mid + 1;
+      }
+      return const_iter(this, lo);
+    }
 
     /**
       Add a new node at the beginning of the active list, and update 'current'
       to point to that node.
     */
     void addFirst() {
-      myList.splice(myList.begin(), myPool, myPool.begin());
-      myCurrent = myList.begin();
+      // The node before the active range is the last one of the pool
+      myHead = myHead == 0 ? myCapacity - 1 : myHead - 1;
+      ++mySize;
+      myCurrent = 0;
     }
 
     /**
@@ -158,8 +229,8 @@ class LinkedObjectPool
       to point to that node.
     */
     void addLast() {
-      myList.splice(myList.end(), myPool, myPool.begin());
-      myCurrent = std::prev(myList.end(), 1);
+      // The node after the active range is the first one of the pool
+      myCurrent = mySize++;
     }
 
     /**
@@ -167,10 +238,10 @@ class LinkedObjectPool
       happens to be the one removed.
     */
     void removeFirst() {
-      const_iter i = myList.cbegin();
-      myPool.splice(myPool.end(), myList, i);
-      if(myCurrent == i)  // did we just invalidate 'current'
-        moveToNext();     // if so, move to the next node
+      myHead = ringIdx(1);
+      --mySize;
+      if(myCurrent > 0)   // the current node moves one position forward;
+        --myCurrent;      // if it was removed, this is the next node
     }
 
     /**
@@ -178,17 +249,16 @@ class LinkedObjectPool
       happens to be the one removed.
     */
     void removeLast() {
-      const_iter i = std::prev(myList.end(), 1);
-      myPool.splice(myPool.end(), myList, i);
-      if(myCurrent == i)  // did we just invalidate 'current'
-        moveToPrevious(); // if so, move to the previous node
+      --mySize;
+      if(myCurrent >= mySize && myCurrent > 0)  // did we just invalidate 'current'
+        --myCurrent;                            // if so, move to the previous node
     }
 
     /**
       Remove a single element from the active list at position of the iterator.
     */
     void remove(const_iter i) {
-      myPool.splice(myPool.end(), myList, i);
+      remove(i.index());
     }
 
     /**
@@ -197,7 +267,27 @@ class LinkedObjectPool
       and so on).
     */
     void remove(uInt32 index) {
-      myPool.splice(myPool.end(), myList, std::next(myList.begin(), index));
+      T* const removed = myRing[ringIdx(index)];
+
+      // Close the gap by moving the shorter part of the active range,
+      // and return the node to the pool
+      if(index < mySize / 2)
+      {
+        for(uInt32 i = index; i > 0; --i)
+          myRing[ringIdx(i)] = myRing[ringIdx(i - 1)];
+        myRing[myHead] = removed;
+        myHead = ringIdx(1);
+      }
+      else
+      {
+        for(uInt32 i = index; i + 1 < mySize; ++i)
+          myRing[ringIdx(i)] = myRing[ringIdx(i + 1)];
+        myRing[ringIdx(mySize - 1)] = removed;
+      }
+      --mySize;
+
+      if(myCurrent > index)
+        --myCurrent;
     }
 
     /**
@@ -205,7 +295,9 @@ class LinkedObjectPool
       the 'current' node.
     */
     void removeToFirst() {
-      myPool.splice(myPool.end(), myList, myList.begin(), myCurrent);
+      myHead = ringIdx(myCurrent);
+      mySize -= myCurrent;
+      myCurrent = 0;
     }
 
     /**
@@ -213,7 +305,8 @@ class LinkedObjectPool
       active list.
     */
     void removeToLast() {
-      myPool.splice(myPool.end(), myList, std::next(myCurrent, 1), myList.end());
+      if(currentIsValid())
+        mySize = myCurrent + 1;
     }
 
     /**
@@ -223,34 +316,78 @@ class LinkedObjectPool
     void resize(uInt32 capacity) {
       if(myCapacity != capacity)  // only resize when necessary
       {
-        myList.clear();  myPool.clear();
-        myCurrent = myList.end();
+        myChunks.clear();
+        myChunks.emplace_back(make_unique<T[]>(capacity));
+        myRing = make_unique<T*[]>(capacity);
         myCapacity = capacity;
 
         for(uInt32 i = 0; i < myCapacity; ++i)
-          myPool.emplace_back(T());
+          myRing[i] = &myChunks.back()[i];
+        myHead = mySize = myCurrent = 0;
       }
     }
 
+    /**
+      Grow the pool to the specified size, keeping the active list (and the
+      addresses of all nodes); iterators stay valid.
+    */
+    void grow(uInt32 capacity) {
+      if(capacity <= myCapacity)
+        return;
+
+      myChunks.emplace_back(make_unique<T[]>(capacity - myCapacity));
+      unique_ptr<T*[]> ring = make_unique<T*[]>(capacity);
+
+      // The active list moves to the start of the ring, followed by the old
+      // and new pool nodes
+      for(uInt32 i = 0; i < myCapacity; ++i)
+        ring[i] = myRing[ringIdx(i)];
+      for(uInt32 i = myCapacity; i < capacity; ++i)
+        ring[i] = &myChunks.back()[i - myCapacity];
+
+      myRing = std::move(ring);
+      myCapacity = capacity;
+      myHead = 0;
+    }
+
     /**
       Erase entire contents of active list.
     */
     void clear() {
-      myPool.splice(myPool.end(), myList, myList.begin(), myList.end());
-      myCurrent = myList.end();
+      mySize = myCurrent = 0;
     }
 
     uInt32 capacity() const { return myCapacity; }
 
-    uInt32 size() const { return uInt32(myList.size()); }
+    uInt32 size() const { return mySize; }
     bool empty() const  { return size() == 0;           }
     bool full() const   { return size() >= capacity();  }
 
   private:
-    std::list<T> myList, myPool;
+    /**
+      Convert a position in the active list into a position in the ring.
+    */
+    uInt32 ringIdx(uInt32 idx) const {
+      idx += myHead;
+      return idx < myCapacity ? idx : idx - myCapacity;
+    }
+
+    /**
+      Return the node at the given position in the active list.
+    */
+    T& node(uInt32 idx) const { return *myRing[ringIdx(idx)]; }
+
+  private:
+    // All nodes, allocated in chunks (one more each time the pool grows)
+    vector<unique_ptr<T[]>> myChunks;
+
+    // The order of the nodes; the active list starts at 'myHead', the pool
+    // nodes follow after its end
+    unique_ptr<T*[]> myRing;
+    uInt32 myHead, mySize;
 
-    // Current position in the active list (end() indicates an invalid position)
-    iter myCurrent;
+    // Current position in the active list (mySize indicates an invalid position)
+    uInt32 myCurrent;
 
     // Total capacity of the pool
     uInt32 myCapacity;
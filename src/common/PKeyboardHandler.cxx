@@ -459,6 +459,13 @@ void PhysicalKeyboardHandler::handleEvent(StellaKey key, StellaMod mod, bool sta
           myOSystem.state().toggleTimeMachine();
           break;
 
+        case KBDK_M:  // (Shift) Alt-m toggles movie recording (playback)
+          if(StellaModTest::isShift(mod))
+            myOSystem.state().togglePlaybackMode();
+          else
+            myOSystem.state().toggleRecordMode();
+          break;
+
         case KBDK_S:
           myOSystem.png().toggleContinuousSnapshots(StellaModTest::isShift(mod));
           break;
@@ -21,6 +21,7 @@
 #include "Serializer.hxx"
 #include "StateManager.hxx"
 #include "TIA.hxx"
+#include "M6532.hxx"
 #include "EventHandler.hxx"
 
 #include "RewindManager.hxx"
@@ -28,9 +29,34 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 RewindManager::RewindManager(OSystem& system, StateManager& statemgr)
   : myOSystem(system),
-    myStateManager(statemgr)
+    myStateManager(statemgr),
+    mySize(0),
+    myLastStateOwner(nullptr),
+    myMemoryUsed(0),
+    myArchiveRestore(false),
+    myCurrentCycles(0),
+    myCurrentValid(false),
+    myFirstCycles(0),
+    myInputEndCycles(0),
+    myInputEndPending(false),
+    myStopWorker(false)
 {
   setup();
+
+  myWorker = std::thread(&RewindManager::worker, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager::~RewindManager()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myStopWorker = true;
+  }
+  myWorkSignal.notify_one();
+  myWorker.join();
+
+  archiveStates();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -40,11 +66,17 @@ void RewindManager::setup()
 
   const string& prefix = myOSystem.settings().getBool("dev.settings") ? "dev." : "plr.";
 
-  mySize = myOSystem.settings().getInt(prefix + "tm.size");
-  if(mySize != myStateList.capacity())
+  // The initial size of the list; it grows up to the memory budget
+  const uInt32 size = myOSystem.settings().getInt(prefix + "tm.size");
+  if(size != mySize)
+  {
+    mySize = size;
     resize(mySize);
+  }
 
   myUncompressed = myOSystem.settings().getInt(prefix + "tm.uncompressed");
+  myMemoryBudget = uInt64(myOSystem.settings().getInt(prefix + "tm.memory")) << 20;
+  myArchiveEnabled = myOSystem.settings().getBool(prefix + "tm.archive");
 
   myInterval = INTERVAL_CYCLES[0];
   for(int i = 0; i < NUM_INTERVALS; ++i)
@@ -56,13 +88,21 @@ void RewindManager::setup()
     if(HOR_SETTINGS[i] == myOSystem.settings().getString(prefix + "tm.horizon"))
       myHorizon = HORIZON_CYCLES[i];
 
+  calculateFactor();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::calculateFactor()
+{
+  const uInt32 size = myStateList.capacity();
+
   // calc interval growth factor for compression
   // this factor defines the backward horizon
   const double MAX_FACTOR = 1E8;
   double minFactor = 0, maxFactor = MAX_FACTOR;
   myFactor = 1;
 
-  while(myUncompressed < mySize)
+  while(myUncompressed < size)
   {
     double interval = myInterval;
     double cycleSum = interval * (myUncompressed + 1);
@@ -72,7 +112,7 @@ void RewindManager::setup()
     if(myFactor == MAX_FACTOR)
       break;
     // sum up interval cycles (first state is not compressed)
-    for(uInt32 i = myUncompressed + 1; i < mySize; ++i)
+    for(uInt32 i = myUncompressed + 1; i < size; ++i)
     {
       interval *= myFactor;
       cycleSum += interval;
@@ -94,10 +134,9 @@ void RewindManager::setup()
 bool RewindManager::addState(const string& message, bool timeMachine)
 {
   // only check for Time Machine states, ignore for debugger
-  if(timeMachine && myStateList.currentIsValid())
+  if(timeMachine && myCurrentValid)
   {
     // check if the current state has the right interval from the last state
-    RewindState& lastState = myStateList.current();
     uInt32 interval = myInterval;
 
     // adjust frame timed intervals to actual scanlines (vs 262)
@@ -108,43 +147,266 @@ bool RewindManager::addState(const string& message, bool timeMachine)
       interval = interval * scanlines / 262;
     }
 
-    if(myOSystem.console().tia().cycles() - lastState.cycles < interval)
+    if(myOSystem.console().tia().cycles() - myCurrentCycles < interval)
       return false;
   }
 
+  // Serialize the new state first, the list isn't touched if this fails
+  Serializer& s = myStateData;
+
+  s.rewind();  // rewind Serializer internal buffers
+  if(!myStateManager.saveState(s) || !myOSystem.console().tia().saveDisplay(s))
+    return false;
+
+  // Hand the state over to the background thread
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myPendingStates.emplace_back();
+    PendingState& pending = myPendingStates.back();
+    if(!mySpareBuffers.empty())
+    {
+      pending.data.swap(mySpareBuffers.back());
+      mySpareBuffers.pop_back();
+    }
+    pending.data.assign(s.data(), s.data() + s.size());
+    pending.message = message;
+    pending.cycles = myOSystem.console().tia().cycles();
+  }
+  myWorkSignal.notify_one();
+
+  myCurrentCycles = myOSystem.console().tia().cycles();
+  myCurrentValid = true;
+  myLastTimeMachineAdd = timeMachine;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::worker()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  for(;;)
+  {
+    myWorkSignal.wait(lock, [this] { return myStopWorker || !myPendingStates.empty(); });
+    if(myPendingStates.empty())
+      break;
+
+    // References into a deque stay valid while states are added at its end
+    PendingState& pending = myPendingStates.front();
+    lock.unlock();
+    commitState(pending);
+    lock.lock();
+
+    mySpareBuffers.emplace_back(std::move(pending.data));
+    myPendingStates.pop_front();
+    if(myPendingStates.empty())
+      myDoneSignal.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::flush() const
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+  myDoneSignal.wait(lock, [this] { return myPendingStates.empty(); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::commitState(PendingState& pending)
+{
+  // Continuing from an earlier state changes the timeline
+  uInt64 cycles;
+  if(myStateList.currentIsValid() &&
+     myArchive.findAfter(myStateList.current().cycles, cycles))
+    myArchive.truncate(myStateList.current().cycles);
+
   // Remove all future states
+  if(myStateList.currentIsValid())
+    for(StateIter it = myStateList.next(myStateList.currentIter()); it != myStateList.cend(); ++it)
+      myMemoryUsed -= stateMemory(*it);
   myStateList.removeToLast();
 
-  // Make sure we never run out of space
+  // Make sure we never run out of space; as long as the states fit into
+  // the memory budget, the list grows instead of being thinned out
   if(myStateList.full())
-    compressStates();
+  {
+    if(myMemoryUsed < myMemoryBudget)
+    {
+      myStateList.grow(myStateList.capacity() * 2);
+      calculateFactor();
+    }
+    else
+      compressStates();
+  }
+
+  // Encode as delta to the last state, unless a new keyframe is due
+  const ByteArray* base = nullptr;
+  if(!myStateList.empty())
+  {
+    StateIter it = myStateList.last();
+    uInt32 deltas = 1;
+    for(StateIter i = it; !i->keyframe && i != myStateList.first(); --i)
+      ++deltas;
+
+    if(deltas < KEYFRAME_INTERVAL &&
+       (myLastStateOwner == &*it || uncompressState(it, myLastState)))
+      base = &myLastState;
+  }
 
   // Add new state at the end of the list (queue adds at end)
   // This updates the 'current' iterator inside the list
   myStateList.addLast();
   RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+
+  encodeState(pending.data, base, state.data);
+  state.size = uInt32(pending.data.size());
+  state.keyframe = base == nullptr;
+  state.message.swap(pending.message);
+  state.cycles = pending.cycles;
+
+  // The new state is the base for the next one
+  myLastState.swap(pending.data);
+  myLastStateOwner = &state;
+
+  // Thin out the older states until they fit into the memory budget
+  myMemoryUsed += stateMemory(state);
+  while(myMemoryUsed > myMemoryBudget && myStateList.size() > 1)
+    compressStates();
+
+  myFirstCycles = myStateList.first()->cycles;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::recordInput()
+{
+  Serializer& s = myInputData;
 
   s.rewind();  // rewind Serializer internal buffers
-  if(myStateManager.saveState(s) && myOSystem.console().tia().saveDisplay(s))
+  if(!myOSystem.console().riot().saveInput(s))
+    return;
+
+  if(myInputEndPending)
+  {
+    // We went back in time, so the input recorded afterwards is obsolete
+    while(!myInputs.empty() && myInputs.back().cycles > myInputEndCycles)
+      myInputs.pop_back();
+    myInputEndPending = false;
+  }
+  else if(!myInputs.empty() && myInputs.back().data.size() == s.size() &&
+          std::equal(myInputs.back().data.begin(), myInputs.back().data.end(), s.data()))
+    return;  // unchanged
+
+  // The input before the first state is never replayed
+  while(!myInputs.empty() && myInputs.front().cycles < myFirstCycles)
+    myInputs.pop_front();
+
+  myInputs.emplace_back();
+  myInputs.back().cycles = myOSystem.console().tia().cycles();
+  myInputs.back().data.assign(s.data(), s.data() + s.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::seekCycles(uInt64 cycles, bool frameEnd)
+{
+  flush();
+
+  if(myStateList.empty())
+    return false;
+
+  cycles = BSPF::clamp(cycles, getFirstCycles(), getLastCycles());
+
+  // Find the last state before the target
+  StateIter it = myStateList.upperBound(cycles,
+      [](uInt64 c, const RewindState& state) { return c < state.cycles; });
+  myStateList.moveTo(myStateList.previous(it));
+
+  if(restoreState())
+    replay(cycles, frameEnd);
+
+  // Rewinding starts with the state before the target, and the input
+  // is replaced from the target on
+  myLastTimeMachineAdd = true;
+  myInputEndCycles = myOSystem.console().tia().cycles();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::seekFrames(Int32 frames)
+{
+  const TIA& tia = myOSystem.console().tia();
+  const Int64 frameCycles = 76 * std::max(tia.scanlinesLastFrame(), 240u);
+
+  // The frame displayed is the one before the frame being drawn; aim for
+  // the middle of the target frame, since frames may differ in length
+  const Int64 target = Int64(tia.cycles() - tia.frameCycles()) +
+                       (frames - 1) * frameCycles + frameCycles / 2;
+
+  return seekCycles(uInt64(std::max(target, Int64(0))), true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::replay(uInt64 cycles, bool frameEnd)
+{
+  TIA& tia = myOSystem.console().tia();
+  M6532& riot = myOSystem.console().riot();
+  Serializer& s = myInputData;
+
+  // The input recorded up to the state is already part of it
+  auto input = std::upper_bound(myInputs.cbegin(), myInputs.cend(), tia.cycles(),
+      [](uInt64 c, const InputRecord& r) { return c < r.cycles; });
+
+  // Emulate up to the given cycles, or the next input change
+  auto step = [&](uInt64 limit) {
+    const uInt64 start = tia.cycles();
+
+    for(; input != myInputs.cend() && input->cycles <= start; ++input)
+    {
+      s.rewind();
+      s.putByteArray(input->data.data(), uInt32(input->data.size()));
+      s.rewind();
+      riot.loadInput(s);
+    }
+    if(input != myInputs.cend())
+      limit = std::min(limit, input->cycles);
+
+    tia.update(limit - start);
+    return tia.cycles() != start;  // stop if the emulation gets stuck
+  };
+
+  tia.setAudioOutputEnabled(false);
+
+  while(tia.cycles() < cycles && step(cycles)) ;
+
+  // The TIA stops the CPU at the end of each frame
+  if(frameEnd)
   {
-    state.message = message;
-    state.cycles = myOSystem.console().tia().cycles();
-    myLastTimeMachineAdd = timeMachine;
-    return true;
+    const uInt32 frame = tia.frameCount();
+    const uInt64 limit = tia.cycles() + 76 * 1024;
+    while(tia.frameCount() == frame && tia.cycles() < limit && step(limit)) ;
   }
-  return false;
+
+  tia.setAudioOutputEnabled(true);
+
+  // Only the final frame is displayed
+  tia.renderToFrameBuffer();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::rewindStates(uInt32 numStates)
 {
+  flush();
+
   uInt64 startCycles = myOSystem.console().tia().cycles();
   uInt32 i;
   string message;
 
   for(i = 0; i < numStates; ++i)
   {
+    uInt64 cycles;
+
     if(!atFirst())
     {
       if(!myLastTimeMachineAdd)
@@ -155,12 +417,10 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
         // ...except when the last state was added automatically,
         // because that already happened one interval before
         myLastTimeMachineAdd = false;
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
-    else
+    // Continue with the archived states
+    else if(!(myArchive.findBefore(myStateList.first()->cycles, cycles) &&
+              unarchiveState(cycles, true)))
       break;
   }
 
@@ -178,23 +438,25 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::unwindStates(uInt32 numStates)
 {
+  flush();
+
   uInt64 startCycles = myOSystem.console().tia().cycles();
   uInt32 i;
   string message;
 
   for(i = 0; i < numStates; ++i)
   {
+    uInt64 cycles;
+
     if(!atLast())
     {
       // Set internal current iterator to nextCycles state (forward in time),
       // since we will now process this state
       myStateList.moveToNext();
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
-    else
+    // Continue with the archived states
+    else if(!(myArchive.findAfter(myStateList.last()->cycles, cycles) &&
+              unarchiveState(cycles, false)))
       break;
   }
 
@@ -219,6 +481,39 @@ uInt32 RewindManager::windStates(uInt32 numStates, bool unwind)
 }
 
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::resize(uInt32 size)
+{
+  flush();
+  archiveStates();
+
+  myStateList.resize(size);
+  myLastStateOwner = nullptr;
+  myMemoryUsed = 0;
+  myInputs.clear();
+  myInputEndPending = false;
+  myFirstCycles = 0;
+  myCurrentValid = myStateList.currentIsValid();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::clear()
+{
+  flush();
+  archiveStates();
+  logArchiveSize("saved");
+  myArchive.close();
+  myArchiveRestore = false;
+
+  myStateList.clear();
+  myLastStateOwner = nullptr;
+  myMemoryUsed = 0;
+  myInputs.clear();
+  myInputEndPending = false;
+  myFirstCycles = 0;
+  myCurrentValid = false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RewindManager::compressStates()
 {
@@ -232,9 +527,10 @@ void RewindManager::compressStates()
     removeIter++;*/
 
   // iterate from last but one to first but one
+  // (the last myUncompressed states are never removed)
   for(auto it = myStateList.previous(myStateList.last()); it != myStateList.first(); --it)
   {
-    if(idx < mySize - myUncompressed)
+    if(idx + myUncompressed < myStateList.size())
     {
       expectedCycles *= myFactor;
 
@@ -250,18 +546,364 @@ void RewindManager::compressStates()
     }
     --idx;
   }
-   myStateList.remove(removeIter); // remove
+  removeState(removeIter);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
+void RewindManager::removeState(StateIter it)
+{
+  StateIter next = myStateList.next(it);
+
+  archiveState(it);
+
+  // The next state is a delta to the removed one; re-encode it as delta to
+  // the state before the removed one.  It becomes a keyframe if there is
+  // none, or if the removed state was a keyframe itself (so that two chains
+  // of deltas are never joined, and decoding stays bounded by the keyframe
+  // interval)
+  if(next != myStateList.cend() && !next->keyframe)
+  {
+    RewindState& state = myStateList.at(next);
+    const ByteArray* base = nullptr;
+
+    if(uncompressState(next, myStateBuffer))
+    {
+      if(!it->keyframe && it != myStateList.first() &&
+         uncompressState(myStateList.previous(it), myBaseBuffer))
+        base = &myBaseBuffer;
+
+      myMemoryUsed -= stateMemory(state);
+      encodeState(myStateBuffer, base, state.data);
+      state.keyframe = base == nullptr;
+      myMemoryUsed += stateMemory(state);
+    }
+  }
+  if(myLastStateOwner == &*it)
+    myLastStateOwner = nullptr;
+
+  myMemoryUsed -= stateMemory(*it);
+
+  myStateList.remove(it);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::openArchive(bool restore)
+{
+  flush();
+
+  myArchive.close();
+  myArchiveRestore = false;
+
+  if(!myArchiveEnabled || !myOSystem.hasConsole())
+    return;
+
+  const string& filename = myOSystem.stateDir() +
+      myOSystem.console().properties().get(Cartridge_MD5) + ".tma";
+
+  if(myArchive.open(filename, !restore))
+  {
+    myArchiveRestore = !myArchive.empty();
+    logArchiveSize("opened");
+  }
+  else
+    myOSystem.logMessage("ERROR: Couldn't open Time Machine archive " + filename, 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::restoreArchive()
+{
+  if(!myArchiveRestore)
+    return;
+  myArchiveRestore = false;
+
+  flush();
+
+  uInt64 cycles;
+  if(myArchive.findBefore(~uInt64(0), cycles))
+  {
+    // Start a new list with the last archived state
+    myStateList.clear();
+    myMemoryUsed = 0;
+    myLastStateOwner = nullptr;
+    myInputs.clear();
+
+    if(unarchiveState(cycles, false) && restoreState())
+    {
+      myLastTimeMachineAdd = false;
+      myOSystem.frameBuffer().showMessage("Time Machine session restored");
+    }
+    else
+    {
+      // The archive doesn't match the current ROM/emulator version (or is
+      // corrupt); don't continue with it, and don't keep adding to it
+      myStateList.clear();
+      myMemoryUsed = 0;
+      myLastStateOwner = nullptr;
+      myCurrentValid = false;
+      myArchive.discard();
+
+      myOSystem.logMessage("ERROR: Couldn't restore Time Machine archive, discarded", 0);
+      myOSystem.frameBuffer().showMessage("Time Machine session not restored");
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::archiveState(StateIter it)
+{
+  if(!myArchive.isOpen() || myArchive.contains(it->cycles))
+    return;
+
+  // Archived states are stored completely
+  if(it->keyframe)
+    myArchive.append(it->cycles, it->data, it->size);
+  else if(uncompressState(it, myStateBuffer))
+  {
+    encodeState(myStateBuffer, nullptr, myArchiveBuffer);
+    myArchive.append(it->cycles, myArchiveBuffer, it->size);
+  }
+  limitArchive();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::archiveStates()
+{
+  if(!myArchive.isOpen())
+    return;
+
+  // Decode the states one after the other, instead of decoding each one
+  // from its keyframe
+  for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
+  {
+    if(!decodeState(it->data, it->size, it->keyframe ? nullptr : &myStateBuffer,
+                    myDecodeBuffer))
+      break;
+    myStateBuffer.swap(myDecodeBuffer);
+
+    if(!myArchive.contains(it->cycles))
+    {
+      if(it->keyframe)
+        myArchive.append(it->cycles, it->data, it->size);
+      else
+      {
+        encodeState(myStateBuffer, nullptr, myArchiveBuffer);
+        myArchive.append(it->cycles, myArchiveBuffer, it->size);
+      }
+    }
+  }
+  limitArchive();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::limitArchive()
+{
+  // The archive may use as much disk space as the states in memory; when
+  // that is exceeded, drop the oldest states (and all replaced records),
+  // keeping some room so this doesn't happen again with the next state
+  if(!myArchive.isOpen() || myArchive.fileSize() <= myMemoryBudget)
+    return;
+
+  if(myArchive.compact(myMemoryBudget * 3 / 4))
+    logArchiveSize("compacted");
+  else
+    myOSystem.logMessage("ERROR: Couldn't compact Time Machine archive", 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::logArchiveSize(const string& action) const
+{
+  if(!myArchive.isOpen())
+    return;
+
+  ostringstream buf;
+  buf << "Time Machine archive " << action << ": " << myArchive.numStates()
+      << " states, " << (myArchive.fileSize() >> 10) << " KB";
+  myOSystem.logMessage(buf.str(), 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::unarchiveState(uInt64 cycles, bool first)
+{
+  uInt32 size;
+  if(!myArchive.read(cycles, myArchiveBuffer, size))
+    return false;
+
+  // Make room at the other end of the list (that state gets archived)
+  if(myStateList.full())
+    removeState(first ? myStateList.last() : myStateList.first());
+
+  if(first)
+    myStateList.addFirst();
+  else
+    myStateList.addLast();
+
+  RewindState& state = myStateList.current();
+  state.data.swap(myArchiveBuffer);
+  state.size = size;
+  state.keyframe = true;
+  state.message.clear();
+  state.cycles = cycles;
+
+  myMemoryUsed += stateMemory(state);
+  myFirstCycles = myStateList.first()->cycles;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::uncompressState(StateIter it, ByteArray& state)
+{
+  // Find the keyframe the state depends on
+  StateIter key = it;
+  while(!key->keyframe)
+  {
+    if(key == myStateList.first())
+      return false;
+    --key;
+  }
+
+  // Decode the keyframe, and apply all deltas up to the state
+  if(!decodeState(key->data, key->size, nullptr, state))
+    return false;
+  while(key != it)
+  {
+    ++key;
+    if(!decodeState(key->data, key->size, &state, myDecodeBuffer))
+      return false;
+    state.swap(myDecodeBuffer);
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::encodeState(const ByteArray& state, const ByteArray* base,
+                                ByteArray& out)
+{
+  // The data is encoded as a sequence of blocks, each consisting of the
+  // number of zero bytes, the number of literal bytes, and the literal bytes
+  // The numbers are stored with 7 bits per byte (bit 7 = more bytes follow)
+  const uInt32 size = uInt32(state.size());
+  const uInt32 baseSize = base ? uInt32(std::min(base->size(), state.size())) : 0;
+
+  auto byteAt = [&](uInt32 i) -> uInt8 {
+    return i < baseSize ? state[i] ^ (*base)[i] : state[i];
+  };
+  auto putCount = [&out](uInt32 count) {
+    while(count >= 0x80)
+    {
+      out.push_back(uInt8(count | 0x80));
+      count >>= 7;
+    }
+    out.push_back(uInt8(count));
+  };
+
+  out.clear();
+  uInt32 i = 0;
+  while(i < size)
+  {
+    uInt32 start = i;
+    while(i < size && byteAt(i) == 0)
+      ++i;
+    putCount(i - start);
+
+    // Literals end at the next run of three zero bytes; shorter runs are
+    // cheaper to store as literals
+    start = i;
+    while(i < size && !(byteAt(i) == 0 &&
+          (i + 1 >= size || byteAt(i + 1) == 0) &&
+          (i + 2 >= size || byteAt(i + 2) == 0)))
+      ++i;
+    putCount(i - start);
+    for(uInt32 j = start; j < i; ++j)
+      out.push_back(byteAt(j));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::decodeState(const ByteArray& in, uInt32 size,
+                                const ByteArray* base, ByteArray& out)
+{
+  size_t pos = 0;
+  auto getCount = [&in, &pos](uInt32& count) {
+    count = 0;
+    for(uInt32 shift = 0; pos < in.size() && shift < 32; shift += 7)
+    {
+      uInt8 b = in[pos++];
+      count |= uInt32(b & 0x7f) << shift;
+      if(!(b & 0x80))
+        return true;
+    }
+    return false;
+  };
+
+  out.resize(size);
+  uInt32 i = 0;
+  while(i < size)
+  {
+    uInt32 zeros, literals;
+    if(!getCount(zeros) || zeros > size - i)
+      return false;
+    std::fill_n(out.begin() + i, zeros, 0);
+    i += zeros;
+
+    if(!getCount(literals) || literals > size - i || literals > in.size() - pos)
+      return false;
+    std::copy_n(in.begin() + pos, literals, out.begin() + i);
+    i += literals;
+    pos += literals;
+  }
+
+  if(base)
+  {
+    const size_t baseSize = std::min(base->size(), out.size());
+    for(size_t j = 0; j < baseSize; ++j)
+      out[j] ^= (*base)[j];
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::restoreState()
 {
   RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  Serializer& s = myStateData;
+
+  if(!uncompressState(myStateList.currentIter(), myLastState))
+  {
+    myLastStateOwner = nullptr;
+    return false;
+  }
 
-  myStateManager.loadState(s);
+  s.rewind();  // rewind Serializer internal buffers
+  s.putByteArray(myLastState.data(), uInt32(myLastState.size()));
+  s.rewind();
+  if(!myStateManager.loadState(s))
+  {
+    myLastStateOwner = nullptr;
+    return false;
+  }
   myOSystem.console().tia().loadDisplay(s);
 
+  // Adding a new state removes all later ones, so this will be its base
+  myLastStateOwner = &state;
+  myCurrentCycles = state.cycles;
+
+  // Any input recorded from now on replaces the recorded future
+  myInputEndCycles = state.cycles;
+  myInputEndPending = true;
+  myCurrentValid = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
+{
+  RewindState& state = myStateList.current();
+
+  if(!restoreState())
+    return "Corrupt Time Machine state";
+
   Int64 diff = startCycles - state.cycles;
   stringstream message;
 
@@ -310,12 +952,16 @@ string RewindManager::getUnitString(Int64 cycles)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getFirstCycles() const
 {
+  flush();
+
   return !myStateList.empty() ? myStateList.first()->cycles : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getCurrentCycles() const
 {
+  flush();
+
   if(myStateList.currentIsValid())
     return myStateList.current().cycles;
   else
@@ -325,12 +971,16 @@ uInt64 RewindManager::getCurrentCycles() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getLastCycles() const
 {
+  flush();
+
   return !myStateList.empty() ? myStateList.last()->cycles : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 IntArray RewindManager::cyclesList() const
 {
+  flush();
+
   IntArray arr;
 
   uInt64 firstCycle = getFirstCycles();
@@ -339,3 +989,21 @@ IntArray RewindManager::cyclesList() const
 
   return arr;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 RewindManager::getMemoryUsed() const
+{
+  flush();
+
+  return myMemoryUsed;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 RewindManager::getMemoryPerSecond() const
+{
+  const Int32 scanlines = std::max(myOSystem.console().tia().scanlinesLastFrame(), 240u);
+  const uInt64 freq = scanlines <= 287 ? 1193182 : 1182298; // = cycles/second
+  const uInt64 cycles = getLastCycles() - getFirstCycles();
+
+  return cycles ? getMemoryUsed() * freq / cycles : 0;
+}
@@ -21,7 +21,15 @@
 class OSystem;
 class StateManager;
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include "LinkedObjectPool.hxx"
+#include "Serializer.hxx"
+#include "StateArchive.hxx"
 #include "bspf.hxx"
 
 /**
@@ -38,8 +46,35 @@ class StateManager;
   to the end of the list (aka, all future states) are removed, and the internal
   iterator moves to the insertion point of the data (the end of the list).
 
-  If the list is full, states are either removed at the beginning (compression
-  off) or at selective positions (compression on).
+  The list starts out with the configured size, and grows as long as its
+  states use less memory than the configured budget.  Once they use more,
+  states are either removed at the beginning (compression off) or at
+  selective positions (compression on).  In the latter case, the most recent
+  states keep their initial interval, while older ones are thinned out to
+  increasingly coarser intervals.
+
+  To save memory, only every KEYFRAME_INTERVAL'th state is stored completely
+  (keyframe).  All other states are stored as the difference (XOR) to the
+  previous state, which is mostly zeroes, and all states are run-length
+  encoded.  Restoring a state thus means decoding at most KEYFRAME_INTERVAL
+  states, starting from the previous keyframe.
+
+  The emulation only serializes the new states; encoding them and updating
+  the list is done by a background thread.  All methods querying or
+  modifying the list wait for the pending states to be committed first, so
+  they never see a partially added state.
+
+  Additionally, all changes of the input (controllers and console switches)
+  are recorded.  This allows seeking to any point in time covered by the
+  list: the last state before it is loaded, and the emulation is replayed
+  from there with the recorded input (without audio, and without displaying
+  the intermediate frames).
+
+  Optionally, all states removed from the list (and all states left when the
+  ROM is closed) are kept in an archive file in the state directory.  When
+  rewinding/unwinding beyond the ends of the list, the states are read back
+  from there.  When the same ROM is opened again, the last archived state
+  is loaded, continuing the previous session.
 
   @author  Stephen Anthony
 */
@@ -47,6 +82,7 @@ class RewindManager
 {
   public:
     RewindManager(OSystem& system, StateManager& statemgr);
+    ~RewindManager();
 
   public:
     static constexpr int NUM_INTERVALS = 7;
@@ -136,18 +172,58 @@ class RewindManager
     */
     uInt32 windStates(uInt32 numStates, bool unwind);
 
-    bool atFirst() const { return myStateList.atFirst(); }
-    bool atLast() const  { return myStateList.atLast();  }
-    void resize(uInt32 size) { myStateList.resize(size); }
-    void clear() { myStateList.clear(); }
+    /**
+      Record the current input (controllers and console switches), if it
+      has changed since the last call.  Must be called after the input has
+      been updated, before the emulation continues.
+    */
+    void recordInput();
+
+    /**
+      Seek to the given cycle count by loading the last state before it, and
+      replaying the emulation with the recorded input up to it.
+
+      @param cycles    The target cycle count (limited to the list)
+      @param frameEnd  Continue until the frame at the target is completed
+      @return  False if the list is empty, else true
+    */
+    bool seekCycles(uInt64 cycles, bool frameEnd = false);
+
+    /**
+      Seek forwards/backwards by the given number of frames.  The seek ends
+      when the target frame is completed, so it can be displayed.
+
+      @param frames  The number of frames to seek (negative = backwards)
+      @return  False if the list is empty, else true
+    */
+    bool seekFrames(Int32 frames);
+
+    /**
+      Open the archive of the current ROM (if enabled).
+
+      @param restore  Continue with the last archived state (otherwise the
+                      archive is discarded)
+    */
+    void openArchive(bool restore);
+
+    /**
+      Load the last archived state, if requested when opening the archive.
+      This is done once the emulation runs.
+    */
+    void restoreArchive();
+
+    bool atFirst() const { flush();  return myStateList.atFirst(); }
+    bool atLast() const  { flush();  return myStateList.atLast();  }
+    void resize(uInt32 size);
+    void clear();
 
     /**
       Convert the cycles into a unit string.
     */
     string getUnitString(Int64 cycles);
 
-    uInt32 getCurrentIdx() { return myStateList.currentIdx(); }
-    uInt32 getLastIdx() { return myStateList.size(); }
+    uInt32 getCurrentIdx() { flush();  return myStateList.currentIdx(); }
+    uInt32 getLastIdx() { flush();  return myStateList.size(); }
 
     uInt64 getFirstCycles() const;
     uInt64 getCurrentCycles() const;
@@ -159,6 +235,23 @@ class RewindManager
     */
     IntArray cyclesList() const;
 
+    /**
+      Answer the memory used by the (compressed) states in the list, and
+      the memory they may use at most.
+    */
+    uInt64 getMemoryUsed() const;
+    uInt64 getMemoryBudget() const { return myMemoryBudget; }
+
+    /**
+      Answer the memory used per second of emulation covered by the list.
+    */
+    uInt64 getMemoryPerSecond() const;
+
+    /**
+      Wait until all states added so far are encoded and in the list.
+    */
+    void flush() const;
+
   private:
     OSystem& myOSystem;
     StateManager& myStateManager;
@@ -167,18 +260,25 @@ class RewindManager
     uInt32 myUncompressed;
     uInt32 myInterval;
     uInt64 myHorizon;
+    uInt64 myMemoryBudget;
+    bool   myArchiveEnabled;
     double myFactor;
     bool   myLastTimeMachineAdd;
 
+    // Every n'th state is stored completely, all others are deltas
+    static constexpr uInt32 KEYFRAME_INTERVAL = 30;
+
     struct RewindState {
-      Serializer data;  // actual save state
+      ByteArray data;   // actual save state, compressed
+      uInt32 size;      // size of the uncompressed save state
+      bool keyframe;    // complete state, or delta to the previous state
       string message;   // describes save state origin
       uInt64 cycles;    // cycles since emulation started
 
       // We do nothing on object instantiation or copy
       // The goal of LinkedObjectPool is to not do any allocations at all
-      RewindState() : cycles(0) { }
-      RewindState(const RewindState& rs) : cycles(rs.cycles) { }
+      RewindState() : size(0), keyframe(true), cycles(0) { }
+      RewindState(const RewindState& rs) : size(0), keyframe(true), cycles(rs.cycles) { }
       RewindState& operator= (const RewindState& rs) { cycles = rs.cycles; return *this; }
 
       // Output object info; used for debugging only
@@ -190,12 +290,179 @@ class RewindManager
     // The linked-list to store states (internally it takes care of reducing
     // frequent (de)-allocations)
     Common::LinkedObjectPool<RewindState> myStateList;
+    using StateIter = Common::LinkedObjectPool<RewindState>::const_iter;
+
+    // Used to (un)serialize the states
+    Serializer myStateData;
+
+    // The uncompressed last state in the list (the base for the next delta),
+    // and the state it belongs to
+    ByteArray myLastState;
+    const RewindState* myLastStateOwner;
+
+    // Memory currently used by the states in the list
+    uInt64 myMemoryUsed;
+
+    // Temporary buffers for encoding and decoding states
+    ByteArray myStateBuffer, myBaseBuffer, myDecodeBuffer, myArchiveBuffer;
+
+    // The states removed from the list, and whether to continue with the
+    // last of these
+    StateArchive myArchive;
+    bool myArchiveRestore;
+
+    // A serialized state waiting to be encoded and added to the list
+    struct PendingState {
+      ByteArray data;
+      string message;
+      uInt64 cycles;
+    };
+
+    // The states not yet committed to the list, and used buffers for
+    // new ones (so that no allocations are required during emulation)
+    std::deque<PendingState> myPendingStates;
+    vector<ByteArray> mySpareBuffers;
+
+    // Cycles of the current state, as seen from the emulation (the list
+    // itself may not be up to date)
+    uInt64 myCurrentCycles;
+    bool myCurrentValid;
+
+    // Cycles of the first state in the list, as updated by the background
+    // thread (older input records can be discarded)
+    std::atomic<uInt64> myFirstCycles;
+
+    // The input as changed at the given cycles, as stored by M6532::saveInput()
+    struct InputRecord {
+      uInt64 cycles;
+      ByteArray data;
+    };
+    std::deque<InputRecord> myInputs;
+    Serializer myInputData;
+
+    // After going back in time, all input recorded after these cycles is
+    // replaced by the next recorded input
+    uInt64 myInputEndCycles;
+    bool myInputEndPending;
+
+    // The background thread encoding the pending states
+    std::thread myWorker;
+    mutable std::mutex myMutex;
+    mutable std::condition_variable myWorkSignal, myDoneSignal;
+    bool myStopWorker;
+
+    /**
+      The main loop of the background thread.
+    */
+    void worker();
+
+    /**
+      Encode the given state and add it at the end of the list, removing
+      all future states (and old ones, if the list is full).
+    */
+    void commitState(PendingState& pending);
 
     /**
       Remove a save state from the list
     */
     void compressStates();
 
+    /**
+      Calculate the interval growth factor for compression, so that the
+      states in the list reach the horizon.
+    */
+    void calculateFactor();
+
+    /**
+      Answer the memory used by the given state in the list.
+    */
+    static uInt64 stateMemory(const RewindState& state) {
+      return state.data.size() + sizeof(RewindState);
+    }
+
+    /**
+      Remove the given state from the list, re-encoding the next state
+      if it depends on the removed one.
+    */
+    void removeState(StateIter it);
+
+    /**
+      Add the given state/all states in the list to the archive (if not
+      archived already).
+    */
+    void archiveState(StateIter it);
+    void archiveStates();
+
+    /**
+      Compact the archive when its file exceeds the memory budget.
+    */
+    void limitArchive();
+
+    /**
+      Log the number of archived states and the size of the archive file.
+
+      @param action  What has just been done with the archive
+    */
+    void logArchiveSize(const string& action) const;
+
+    /**
+      Read the given state from the archive, and add it to the list, making
+      it the current state.  If the list is full, the state at the other
+      end of the list is removed.
+
+      @param cycles  The cycle count of the archived state
+      @param first   Add the state at the beginning (else the end) of the list
+      @return  False on any errors, else true
+    */
+    bool unarchiveState(uInt64 cycles, bool first);
+
+    /**
+      Restore the complete (uncompressed) data of the given state.
+
+      @param it     The state to restore
+      @param state  Receives the uncompressed state
+      @return  False on any errors, else true
+    */
+    bool uncompressState(StateIter it, ByteArray& state);
+
+    /**
+      Run-length encode the given state, optionally as XOR delta to a base.
+
+      @param state  The uncompressed state
+      @param base   The previous uncompressed state, or nullptr for a keyframe
+      @param out    Receives the encoded state
+    */
+    static void encodeState(const ByteArray& state, const ByteArray* base,
+                            ByteArray& out);
+
+    /**
+      Decode a state encoded by encodeState().
+
+      @param in     The encoded state
+      @param size   The size of the uncompressed state
+      @param base   The previous uncompressed state, or nullptr for a keyframe
+      @param out    Receives the uncompressed state
+      @return  False if the data is corrupt, else true
+    */
+    static bool decodeState(const ByteArray& in, uInt32 size,
+                            const ByteArray* base, ByteArray& out);
+
+    /**
+      Replay the emulation (starting at the current state) with the recorded
+      input, without any audio output.
+
+      @param cycles    The cycle count to replay to
+      @param frameEnd  Continue until the frame at the target is completed
+    */
+    void replay(uInt64 cycles, bool frameEnd);
+
+    /**
+      Load the current state into the emulation.
+
+      @return  False on any errors, else true
+    */
+    bool restoreState();
+
     /**
       Load the current state and get the message string for the rewind/unwind
 
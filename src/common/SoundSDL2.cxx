@@ -20,6 +20,7 @@
 #include <sstream>
 #include <cassert>
 #include <cmath>
+#include <chrono>
 
 #include "SDL_lib.hxx"
 #include "FrameBuffer.hxx"
@@ -33,6 +34,12 @@
 #include "AudioSettings.hxx"
 #include "audio/SimpleResampler.hxx"
 #include "audio/LanczosResampler.hxx"
+#include "audio/BLEPResampler.hxx"
+#include "audio/DynamicRateControl.hxx"
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 SoundSDL2::SoundSDL2(OSystem& osystem, AudioSettings& audioSettings)
@@ -44,6 +51,8 @@ SoundSDL2::SoundSDL2(OSystem& osystem, AudioSettings& audioSettings)
     myEmulationTiming(nullptr),
     myCurrentFragment(nullptr),
     myUnderrun(false),
+    myLatencySum(0),
+    myLatencyCount(0),
     myAudioSettings(audioSettings)
 {
   myOSystem.logMessage("SoundSDL2::SoundSDL2 started ...", 2);
@@ -141,6 +150,8 @@ void SoundSDL2::open(shared_ptr<AudioQueue> audioQueue,
   myAudioQueue = audioQueue;
   myUnderrun = true;
   myCurrentFragment = nullptr;
+  myLatencySum = 0;
+  myLatencyCount = 0;
 
   // Adjust volume to that defined in settings
   setVolume(myAudioSettings.volume());
@@ -165,7 +176,10 @@ void SoundSDL2::close()
 
   mute(true);
 
-  if (myAudioQueue) myAudioQueue->closeSink(myCurrentFragment);
+  if (myAudioQueue) {
+    reportLatency();
+    myAudioQueue->closeSink(myCurrentFragment);
+  }
   myAudioQueue.reset();
   myCurrentFragment = nullptr;
 
@@ -192,6 +206,7 @@ void SoundSDL2::setVolume(uInt32 percent)
 
     SDL_LockAudioDevice(myDevice);
     myVolumeFactor = static_cast<float>(percent) / 100.f;
+    if (myResampler) myResampler->setVolume(myVolumeFactor);
     SDL_UnlockAudioDevice(myDevice);
   }
 }
@@ -247,6 +262,9 @@ string SoundSDL2::about() const
     case AudioSettings::Preset::veryHighQualityVeryLowLag:
       buf << "Very high quality, very low lag" << endl;
       break;
+    case AudioSettings::Preset::lowLatency:
+      buf << "Low latency, dynamic rate" << endl;
+      break;
   }
   buf << "    Fragment size: " << uInt32(myHardwareSpec.samples) << " bytes" << endl
       << "    Sample rate:   " << uInt32(myHardwareSpec.freq) << " Hz" << endl;
@@ -262,20 +280,32 @@ string SoundSDL2::about() const
     case AudioSettings::ResamplingQuality::lanczos_3:
       buf << "Quality 3, Lanczos (a = 3)" << endl;
       break;
+    case AudioSettings::ResamplingQuality::blep:
+      buf << "Quality 4, band-limited steps" << endl;
+      break;
   }
   buf << "    Headroom:      " << std::fixed << std::setprecision(1)
       << (0.5 * myAudioSettings.headroom()) << " frames" << endl
       << "    Buffer size:   " << std::fixed << std::setprecision(1)
-      << (0.5 * myAudioSettings.bufferSize()) << " frames" << endl;
+      << (0.5 * myAudioSettings.bufferSize()) << " frames" << endl
+      << "    Dynamic rate:  " << (myRateControl ? "enabled" : "disabled") << endl;
   return buf.str();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL2::processFragment(float* stream, uInt32 length)
 {
-  myResampler->fillFragment(stream, length);
+  const uInt32 queued = myAudioQueue->size();
 
-  for (uInt32 i = 0; i < length; i++) stream[i] = stream[i] * myVolumeFactor;
+  if (myRateControl) myResampler->adjustRate(myRateControl->update(queued));
+
+  myLatencySum += double(queued * myAudioQueue->fragmentSize()) / myEmulationTiming->audioSampleRate();
+  ++myLatencyCount;
+
+  const steady_clock::time_point start = steady_clock::now();
+  myResampler->fillFragment(stream, length);
+  myAudioQueue->stats().recordTime(AudioStats::Timing::resampling,
+    duration_cast<microseconds>(steady_clock::now() - start).count());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -314,9 +344,39 @@ void SoundSDL2::initResampler()
       myResampler = make_unique<LanczosResampler>(formatFrom, formatTo, nextFragmentCallback, 3);
       break;
 
+    case AudioSettings::ResamplingQuality::blep:
+      myResampler = make_unique<BLEPResampler>(formatFrom, formatTo, nextFragmentCallback);
+      break;
+
     default:
       throw runtime_error("invalid resampling quality");
   }
+
+  // The volume is applied by the resampler, as part of the conversion to float
+  myResampler->setVolume(myVolumeFactor);
+
+  // Converge to the fill level where playback starts
+  myRateControl = myAudioSettings.dynamicRate() ?
+    make_unique<DynamicRateControl>(
+      myEmulationTiming->audioSampleRate(), myAudioQueue->fragmentSize(),
+      double(myHardwareSpec.freq) / myHardwareSpec.samples,
+      myEmulationTiming->prebufferFragmentCount()
+    ) : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL2::reportLatency()
+{
+  if (myLatencyCount == 0) return;
+
+  // The queued audio plus one fragment in the device buffer
+  const double latency = myLatencySum / myLatencyCount +
+    double(myHardwareSpec.samples) / myHardwareSpec.freq;
+
+  ostringstream buf;
+  buf << "Average audio latency: " << std::fixed << std::setprecision(1)
+      << (latency * 1000) << " ms" << (myRateControl ? " (dynamic rate)" : "");
+  myOSystem.logMessage(buf.str(), 1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -324,8 +384,12 @@ void SoundSDL2::callback(void* udata, uInt8* stream, int len)
 {
   SoundSDL2* self = static_cast<SoundSDL2*>(udata);
 
-  if (self->myAudioQueue)
+  if (self->myAudioQueue) {
+    const steady_clock::time_point start = steady_clock::now();
     self->processFragment(reinterpret_cast<float*>(stream), len >> 2);
+    self->myAudioQueue->stats().recordTime(AudioStats::Timing::callback,
+      duration_cast<microseconds>(steady_clock::now() - start).count());
+  }
   else
     SDL_memset(stream, 0, len);
 }
@@ -24,6 +24,7 @@ class OSystem;
 class AudioQueue;
 class EmulationTiming;
 class AudioSettings;
+class DynamicRateControl;
 
 #include "SDL_lib.hxx"
 
@@ -122,6 +123,11 @@ class SoundSDL2 : public Sound
 
     void initResampler();
 
+    /**
+      Log the average latency measured since the sound was opened.
+    */
+    void reportLatency();
+
   private:
     // Indicates if the sound device was successfully initialized
     bool myIsInitializedFlag;
@@ -144,6 +150,14 @@ class SoundSDL2 : public Sound
 
     unique_ptr<Resampler> myResampler;
 
+    // Adjusts the resampling ratio to the fill level of the queue (optional)
+    unique_ptr<DynamicRateControl> myRateControl;
+
+    // Sum of the latency (in seconds) of the queued audio, measured on each
+    // callback, and the number of measurements
+    double myLatencySum;
+    uInt64 myLatencyCount;
+
     AudioSettings& myAudioSettings;
 
     string myAboutString;
@@ -0,0 +1,302 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cstdio>
+#include <cstring>
+
+#include "StateArchive.hxx"
+
+using std::ios_base;
+
+namespace {
+  // Identifies the file as Time Machine archive, and its format
+  constexpr char MAGIC[] = "StellaTM";
+  constexpr uInt32 MAGIC_SIZE = 8;
+  constexpr uInt32 VERSION = 1;
+  constexpr uInt32 HEADER_SIZE = MAGIC_SIZE + sizeof(uInt32);
+
+  // Record header: cycles, uncompressed size, stored size
+  constexpr uInt32 RECORD_SIZE = sizeof(uInt64) + 2 * sizeof(uInt32);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateArchive::StateArchive()
+  : myEnd(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::open(const string& filename, bool create)
+{
+  close();
+  myFilename = filename;
+
+  if(!create)
+  {
+    myFile.open(filename, ios_base::in | ios_base::out | ios_base::binary);
+    if(myFile.is_open())
+    {
+      char magic[MAGIC_SIZE];
+      uInt32 version = 0;
+
+      myFile.read(magic, MAGIC_SIZE);
+      myFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+      if(myFile && memcmp(magic, MAGIC, MAGIC_SIZE) == 0 && version == VERSION)
+      {
+        scan();
+        return true;
+      }
+      myFile.close();  // unknown format, start a new archive
+    }
+  }
+
+  myFile.open(filename, ios_base::in | ios_base::out | ios_base::binary | ios_base::trunc);
+  if(!myFile.is_open())
+    return false;
+
+  myFile.write(MAGIC, MAGIC_SIZE);
+  myFile.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+  myEnd = HEADER_SIZE;
+
+  if(!myFile)
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateArchive::close()
+{
+  if(myFile.is_open())
+    myFile.close();
+  myFile.clear();
+
+  myIndex.clear();
+  myEnd = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::discard()
+{
+  const string filename = myFilename;
+
+  return !filename.empty() && open(filename, true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateArchive::scan()
+{
+  myFile.seekg(0, ios_base::end);
+  const uInt64 fileSize = uInt64(myFile.tellg());
+
+  // A record cut short (e.g. by a crash) ends the archive, and is
+  // overwritten by the next record
+  myEnd = HEADER_SIZE;
+  while(myEnd + RECORD_SIZE <= fileSize)
+  {
+    Entry entry;
+
+    myFile.seekg(myEnd);
+    myFile.read(reinterpret_cast<char*>(&entry.cycles), sizeof(entry.cycles));
+    myFile.read(reinterpret_cast<char*>(&entry.size), sizeof(entry.size));
+    myFile.read(reinterpret_cast<char*>(&entry.length), sizeof(entry.length));
+    entry.offset = myEnd + RECORD_SIZE;
+
+    if(!myFile || entry.offset + entry.length > fileSize)
+      break;
+
+    addEntry(entry);
+    myEnd = entry.offset + entry.length;
+  }
+  myFile.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateArchive::addEntry(const Entry& entry)
+{
+  auto it = std::lower_bound(myIndex.begin(), myIndex.end(), entry.cycles,
+      [](const Entry& e, uInt64 cycles) { return e.cycles < cycles; });
+
+  if(entry.size == 0)  // truncation marker
+    myIndex.erase(std::upper_bound(myIndex.begin(), myIndex.end(), entry.cycles,
+        [](uInt64 cycles, const Entry& e) { return cycles < e.cycles; }), myIndex.end());
+  else if(it != myIndex.end() && it->cycles == entry.cycles)
+    *it = entry;
+  else
+    myIndex.insert(it, entry);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::contains(uInt64 cycles) const
+{
+  auto it = std::lower_bound(myIndex.begin(), myIndex.end(), cycles,
+      [](const Entry& e, uInt64 c) { return e.cycles < c; });
+
+  return it != myIndex.end() && it->cycles == cycles;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::findBefore(uInt64 cycles, uInt64& found) const
+{
+  auto it = std::lower_bound(myIndex.begin(), myIndex.end(), cycles,
+      [](const Entry& e, uInt64 c) { return e.cycles < c; });
+
+  if(it == myIndex.begin())
+    return false;
+
+  found = (--it)->cycles;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::findAfter(uInt64 cycles, uInt64& found) const
+{
+  auto it = std::upper_bound(myIndex.begin(), myIndex.end(), cycles,
+      [](uInt64 c, const Entry& e) { return c < e.cycles; });
+
+  if(it == myIndex.end())
+    return false;
+
+  found = it->cycles;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::read(uInt64 cycles, ByteArray& data, uInt32& size)
+{
+  auto it = std::lower_bound(myIndex.begin(), myIndex.end(), cycles,
+      [](const Entry& e, uInt64 c) { return e.cycles < c; });
+
+  if(!isOpen() || it == myIndex.end() || it->cycles != cycles)
+    return false;
+
+  // Only the data of this state is read
+  data.resize(it->length);
+  myFile.seekg(it->offset);
+  myFile.read(reinterpret_cast<char*>(data.data()), it->length);
+  size = it->size;
+
+  if(!myFile)
+  {
+    myFile.clear();
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::append(uInt64 cycles, const ByteArray& data, uInt32 size)
+{
+  return size > 0 && writeRecord(cycles, size, data.data(), uInt32(data.size()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::truncate(uInt64 cycles)
+{
+  return writeRecord(cycles, 0, nullptr, 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::writeRecord(uInt64 cycles, uInt32 size,
+                               const uInt8* data, uInt32 length)
+{
+  if(!isOpen())
+    return false;
+
+  Entry entry;
+  entry.cycles = cycles;
+  entry.offset = myEnd + RECORD_SIZE;
+  entry.size = size;
+  entry.length = length;
+
+  myFile.seekp(myEnd);
+  myFile.write(reinterpret_cast<const char*>(&entry.cycles), sizeof(entry.cycles));
+  myFile.write(reinterpret_cast<const char*>(&entry.size), sizeof(entry.size));
+  myFile.write(reinterpret_cast<const char*>(&entry.length), sizeof(entry.length));
+  if(length > 0)
+    myFile.write(reinterpret_cast<const char*>(data), length);
+  myFile.flush();
+
+  if(!myFile)
+  {
+    myFile.clear();
+    return false;
+  }
+
+  addEntry(entry);
+  myEnd = entry.offset + entry.length;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateArchive::compact(uInt64 maxSize)
+{
+  if(!isOpen())
+    return false;
+
+  // Find the latest states which fit into the new file
+  auto first = myIndex.end();
+  uInt64 size = HEADER_SIZE;
+  while(first != myIndex.begin() &&
+        size + RECORD_SIZE + std::prev(first)->length <= maxSize)
+  {
+    --first;
+    size += RECORD_SIZE + first->length;
+  }
+
+  // Write them to a temporary file, which then replaces the archive
+  const string filename = myFilename, tempname = myFilename + ".tmp";
+  {
+    std::ofstream out(tempname, ios_base::binary | ios_base::trunc);
+    ByteArray data;
+
+    out.write(MAGIC, MAGIC_SIZE);
+    out.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    for(auto it = first; it != myIndex.end() && out; ++it)
+    {
+      data.resize(it->length);
+      myFile.seekg(it->offset);
+      myFile.read(reinterpret_cast<char*>(data.data()), it->length);
+      if(!myFile)
+      {
+        myFile.clear();
+        out.setstate(ios_base::failbit);
+        break;
+      }
+      out.write(reinterpret_cast<const char*>(&it->cycles), sizeof(it->cycles));
+      out.write(reinterpret_cast<const char*>(&it->size), sizeof(it->size));
+      out.write(reinterpret_cast<const char*>(&it->length), sizeof(it->length));
+      out.write(reinterpret_cast<const char*>(data.data()), it->length);
+    }
+    out.flush();
+    if(!out)
+    {
+      out.close();
+      std::remove(tempname.c_str());
+      return false;
+    }
+  }
+
+  close();
+  std::remove(filename.c_str());
+  if(std::rename(tempname.c_str(), filename.c_str()) != 0)
+    return false;
+
+  return open(filename, false);
+}
@@ -0,0 +1,175 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STATE_ARCHIVE_HXX
+#define STATE_ARCHIVE_HXX
+
+#include <fstream>
+
+#include "bspf.hxx"
+
+/**
+  An append-only file of (compressed) save states, used to keep the Time
+  Machine history beyond the states held in memory, and across sessions.
+
+  Each record consists of the cycle count of the state, its uncompressed
+  size, the size of the stored data, and the data itself.  A record with
+  an uncompressed size of 0 is a marker, which drops all states stored
+  before it with a higher cycle count (used when the timeline changes).
+  If a state is stored more than once, the last record wins.
+
+  When opening the file, only the record headers are read to build the
+  index (sorted by cycles); the data of a state is read only when that
+  state is requested.
+
+  Since records are only ever appended, the file keeps growing; compact()
+  rewrites it with the latest states only.
+*/
+class StateArchive
+{
+  public:
+    StateArchive();
+    ~StateArchive() = default;
+
+  public:
+    /**
+      Open the given archive file, creating a new one if it doesn't exist
+      (or if requested).
+
+      @param filename  The name of the archive file
+      @param create    Discard any existing archive contents
+      @return  False on any errors, else true
+    */
+    bool open(const string& filename, bool create);
+
+    /**
+      Close the archive file.
+    */
+    void close();
+
+    /**
+      Discard all archived states, and start a new archive in the same file.
+
+      @return  False on any errors, else true
+    */
+    bool discard();
+
+    bool isOpen() const { return myFile.is_open(); }
+    bool empty() const  { return myIndex.empty(); }
+
+    /**
+      The number of archived states, and the size of the file in bytes.
+    */
+    uInt32 numStates() const { return uInt32(myIndex.size()); }
+    uInt64 fileSize() const  { return myEnd; }
+
+    /**
+      Answer whether a state with the given cycle count is archived.
+    */
+    bool contains(uInt64 cycles) const;
+
+    /**
+      Find the last archived state before/the first one after the given
+      cycle count.
+
+      @param cycles  The cycle count to search from
+      @param found   Receives the cycle count of the state found
+      @return  False if there is no such state, else true
+    */
+    bool findBefore(uInt64 cycles, uInt64& found) const;
+    bool findAfter(uInt64 cycles, uInt64& found) const;
+
+    /**
+      Read the archived state with the given cycle count.
+
+      @param cycles  The cycle count of the state
+      @param data    Receives the stored (compressed) state data
+      @param size    Receives the uncompressed size of the state
+      @return  False on any errors, else true
+    */
+    bool read(uInt64 cycles, ByteArray& data, uInt32& size);
+
+    /**
+      Append a state to the archive.
+
+      @param cycles  The cycle count of the state
+      @param data    The (compressed) state data
+      @param size    The uncompressed size of the state
+      @return  False on any errors, else true
+    */
+    bool append(uInt64 cycles, const ByteArray& data, uInt32 size);
+
+    /**
+      Drop all states after the given cycle count.
+
+      @param cycles  The cycle count of the last state to keep
+      @return  False on any errors, else true
+    */
+    bool truncate(uInt64 cycles);
+
+    /**
+      Rewrite the archive file, keeping only the latest states which fit
+      into the given size.  Replaced and dropped records are removed.
+
+      @param maxSize  The maximum size of the new file in bytes
+      @return  False on any errors, else true
+    */
+    bool compact(uInt64 maxSize);
+
+  private:
+    struct Entry {
+      uInt64 cycles;  // cycles of the state
+      uInt64 offset;  // file offset of the state data
+      uInt32 size;    // uncompressed size of the state
+      uInt32 length;  // size of the stored data
+    };
+
+    /**
+      Read the record headers, and build the index from them.
+    */
+    void scan();
+
+    /**
+      Write a record header and its data at the end of the file.
+    */
+    bool writeRecord(uInt64 cycles, uInt32 size, const uInt8* data, uInt32 length);
+
+    /**
+      Add the given entry to the index, or apply the truncation marker.
+    */
+    void addEntry(const Entry& entry);
+
+  private:
+    // The archive file, and its name
+    std::fstream myFile;
+    string myFilename;
+
+    // The archived states, sorted by cycles
+    vector<Entry> myIndex;
+
+    // Offset of the end of the last valid record
+    uInt64 myEnd;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StateArchive(const StateArchive&) = delete;
+    StateArchive(StateArchive&&) = delete;
+    StateArchive& operator=(const StateArchive&) = delete;
+    StateArchive& operator=(StateArchive&&) = delete;
+};
+
+#endif
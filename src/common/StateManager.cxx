@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <cstdio>
+
 #include "OSystem.hxx"
 #include "Settings.hxx"
 #include "Console.hxx"
@@ -23,18 +25,22 @@
 #include "Switches.hxx"
 #include "System.hxx"
 #include "Serializable.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
 #include "RewindManager.hxx"
 
 #include "StateManager.hxx"
 
-#define STATE_HEADER "05099200state"
-// #define MOVIE_HEADER "03030000movie"
+#define STATE_HEADER "05099202state"
+#define MOVIE_HEADER "05099200movie"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem& osystem)
   : myOSystem(osystem),
     myCurrentSlot(0),
-    myActiveMode(Mode::Off)
+    myActiveMode(Mode::Off),
+    myMovieCycles(0),
+    myMovieLastCycles(0)
 {
   myRewindManager = make_unique<RewindManager>(myOSystem, *this);
   reset();
@@ -45,94 +51,327 @@ StateManager::~StateManager()
 {
 }
 
-#if 0
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::toggleRecordMode()
 {
-  if(myActiveMode != kMovieRecordMode)  // Turn on movie record mode
+  if(myActiveMode == Mode::MovieRecord)  // Turn off movie record mode
   {
-    myActiveMode = kOffMode;
+    stopMovie();
+    myOSystem.frameBuffer().showMessage("Movie recording stopped");
+    return;
+  }
+  stopMovie();
 
-    string moviefile = /*myOSystem.baseDir() +*/ "test.inp";
-    if(myMovieWriter.isOpen())
-      myMovieWriter.close();
-    if(!myMovieWriter.open(moviefile))
-      return false;
+  // The Serializer doesn't truncate existing files
+  const string& filename = movieFile();
+  std::remove(filename.c_str());
 
-    // Prepend the ROM md5 so this state file only works with that ROM
-    myMovieWriter.putString(myOSystem.console().properties().get(Cartridge_MD5));
+  myMovie = make_unique<Serializer>(filename);
+  if(!*myMovie || !startRecording())
+  {
+    myMovie.reset();
+    myOSystem.frameBuffer().showMessage("Can't create movie file");
+    return;
+  }
 
-    if(!myOSystem.console().save(myMovieWriter))
-      return false;
+  // If we get this far, we're really in movie record mode
+  myActiveMode = Mode::MovieRecord;
+  myOSystem.frameBuffer().showMessage("Movie recording started");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::togglePlaybackMode()
+{
+  if(myActiveMode == Mode::MoviePlayback)  // Turn off movie playback mode
+  {
+    stopMovie();
+    myOSystem.frameBuffer().showMessage("Movie playback stopped");
+    return;
+  }
+  stopMovie();
+
+  myMovie = make_unique<Serializer>(movieFile(), true);
+  if(!*myMovie || !startPlayback())
+  {
+    myMovie.reset();
+    myOSystem.frameBuffer().showMessage("Can't play movie file");
+    return;
+  }
+
+  // If we get this far, we're really in movie playback mode
+  myActiveMode = Mode::MoviePlayback;
+  myOSystem.frameBuffer().showMessage("Movie playback started");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::startRecording()
+{
+  Serializer& out = *myMovie;
+  Console& console = myOSystem.console();
+
+  try
+  {
+    out.putString(MOVIE_HEADER);
+
+    // Prepend the ROM md5 so this movie file only works with that ROM
+    out.putString(console.properties().get(Cartridge_MD5));
 
     // Save controller types for this ROM
     // We need to check this, since some controllers save more state than
-    // normal, and those states files wouldn't be compatible with normal
+    // normal, and those movie files wouldn't be compatible with normal
     // controllers.
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Left).name());
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Right).name());
+    out.putString(console.leftController().name());
+    out.putString(console.rightController().name());
+
+    if(!saveState(out))
+      return false;
 
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMovieRecordMode;
+    // The input is stored completely once, afterwards only the changed
+    // bytes (which must be addressable by an uInt8 offset)
+    myInputData.rewind();
+    if(!console.riot().saveInput(myInputData) || myInputData.size() > 256)
+      return false;
+
+    myMovieInput.assign(myInputData.data(), myInputData.data() + myInputData.size());
+    out.putInt(uInt32(myMovieInput.size()));
+    out.putByteArray(myMovieInput.data(), uInt32(myMovieInput.size()));
   }
-  else  // Turn off movie record mode
+  catch(...)
   {
-    myActiveMode = kOffMode;
-    myMovieWriter.close();
+    cerr << "ERROR: StateManager::startRecording()" << endl;
     return false;
   }
+  myMovieCycles = myMovieLastCycles = console.tia().cycles();
 
-  return myActiveMode == kMovieRecordMode;
-////////////////////////////////////////////////////////
-// FIXME - For now, I'm going to use this to activate movie playback
-  // Close the writer, since we're about to re-open in read mode
-  myMovieWriter.close();
+  return true;
+}
 
-  if(myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
-  {
-    myActiveMode = kOffMode;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::startPlayback()
+{
+  Serializer& in = *myMovie;
+  Console& console = myOSystem.console();
 
-    string moviefile = /*myOSystem.baseDir() + */ "test.inp";
-    if(myMovieReader.isOpen())
-      myMovieReader.close();
-    if(!myMovieReader.open(moviefile))
+  try
+  {
+    if(in.getString() != MOVIE_HEADER)
       return false;
 
     // Check the ROM md5
-    if(myMovieReader.getString() !=
-       myOSystem.console().properties().get(Cartridge_MD5))
+    if(in.getString() != console.properties().get(Cartridge_MD5))
       return false;
 
-    if(!myOSystem.console().load(myMovieReader))
+    // Check controller types
+    const string& left  = in.getString();
+    const string& right = in.getString();
+
+    if(left != console.leftController().name() ||
+       right != console.rightController().name())
       return false;
 
-    // Check controller types
-    const string& left  = myMovieReader.getString();
-    const string& right = myMovieReader.getString();
+    if(!loadState(in))
+      return false;
 
-    if(left != myOSystem.console().controller(Controller::Left).name() ||
-       right != myOSystem.console().controller(Controller::Right).name())
+    const uInt32 size = in.getInt();
+    if(size > 256)
       return false;
 
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMoviePlaybackMode;
+    myMovieInput.resize(size);
+    in.getByteArray(myMovieInput.data(), size);
   }
-  else  // Turn off movie playback mode
+  catch(...)
   {
-    myActiveMode = kOffMode;
-    myMovieReader.close();
+    cerr << "ERROR: StateManager::startPlayback()" << endl;
     return false;
   }
+  loadMovieInput();
+  myMovieCycles = console.tia().cycles();
+
+  return readMovieInput();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::recordMovie()
+{
+  const uInt64 cycles = myOSystem.console().tia().cycles();
+  Serializer& out = *myMovie;
+
+  // Time must not go back while recording (the deltas are unsigned)
+  if(cycles < myMovieCycles)
+  {
+    cerr << "ERROR: StateManager::recordMovie(): cycles went back" << endl;
+    stopMovie();
+    myOSystem.frameBuffer().showMessage("Movie recording stopped");
+    return;
+  }
+
+  myInputData.rewind();
+  if(!myOSystem.console().riot().saveInput(myInputData) ||
+     myInputData.size() != myMovieInput.size())
+    return;
+
+  myMovieLastCycles = cycles;
+
+  const uInt8* input = myInputData.data();
+  uInt32 changes = 0;
+  for(uInt32 i = 0; i < myMovieInput.size(); ++i)
+    changes += input[i] != myMovieInput[i];
+
+  if(changes == 0)
+    return;
+
+  try
+  {
+    out.putLong(cycles - myMovieCycles);
+    out.putByte(uInt8(changes));
+    for(uInt32 i = 0; i < myMovieInput.size(); ++i)
+    {
+      if(input[i] != myMovieInput[i])
+      {
+        out.putByte(uInt8(i));
+        out.putByte(input[i]);
+        myMovieInput[i] = input[i];
+      }
+    }
+  }
+  catch(...)
+  {
+    cerr << "ERROR: StateManager::recordMovie()" << endl;
+    stopMovie();
+    myOSystem.frameBuffer().showMessage("Movie recording failed");
+    return;
+  }
+  myMovieCycles = cycles;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::playMovie()
+{
+  const uInt64 cycles = myOSystem.console().tia().cycles();
+
+  if(myMovieCycles > cycles)
+    return;
+
+  // The emulation timeslice normally ends exactly at the next change, but
+  // e.g. stepping in the debugger may pass it; apply all changes which are due
+  while(myMovieCycles <= cycles)
+  {
+    if(myMovieNext.empty())
+    {
+      stopMovie();
+      myOSystem.frameBuffer().showMessage("Movie playback finished");
+      return;
+    }
+    myMovieInput.swap(myMovieNext);
+    readMovieInput();
+  }
+  loadMovieInput();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::readMovieInput()
+{
+  Serializer& in = *myMovie;
+
+  myMovieNext.clear();
+  try
+  {
+    const uInt64 delta = in.getLong();
+    uInt32 changes = in.getByte();
+
+    // Zero changes mark the end of the movie
+    if(changes > 0)
+    {
+      myMovieNext = myMovieInput;
+      while(changes--)
+      {
+        const uInt8 offset = in.getByte();
+        const uInt8 value = in.getByte();
+        if(offset >= myMovieNext.size())
+        {
+          myMovieNext.clear();
+          return false;
+        }
+        myMovieNext[offset] = value;
+      }
+    }
+    myMovieCycles += delta;
+  }
+  catch(...)
+  {
+    // A truncated movie simply ends here
+    cerr << "ERROR: StateManager::readMovieInput()" << endl;
+    myMovieNext.clear();
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::loadMovieInput()
+{
+  myInputData.rewind();
+  myInputData.putByteArray(myMovieInput.data(), uInt32(myMovieInput.size()));
+  myInputData.rewind();
+  myOSystem.console().riot().loadInput(myInputData);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopMovie()
+{
+  if(!myMovie)
+    return;
+
+  if(myActiveMode == Mode::MovieRecord)
+  {
+    // Mark the end of the movie
+    try
+    {
+      myMovie->putLong(myMovieLastCycles - myMovieCycles);
+      myMovie->putByte(0);
+    }
+    catch(...)
+    {
+      cerr << "ERROR: StateManager::stopMovie()" << endl;
+    }
+  }
+  myMovie.reset();
+
+  myActiveMode = myOSystem.settings().getBool(
+    myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine") ? Mode::TimeMachine : Mode::Off;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::interruptMovie()
+{
+  if(myActiveMode == Mode::MovieRecord)
+  {
+    stopMovie();
+    myOSystem.frameBuffer().showMessage("Movie recording stopped");
+  }
+  else if(myActiveMode == Mode::MoviePlayback)
+  {
+    stopMovie();
+    myOSystem.frameBuffer().showMessage("Movie playback stopped");
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StateManager::movieFile() const
+{
+  return myOSystem.stateDir() +
+         myOSystem.console().properties().get(Cartridge_Name) + ".inp";
 }
-#endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::toggleTimeMachine()
 {
   bool devSettings = myOSystem.settings().getBool("dev.settings");
 
+  // Any movie recording/playback is stopped
+  stopMovie();
+
   myActiveMode = myActiveMode == Mode::TimeMachine ? Mode::Off : Mode::TimeMachine;
   if(myActiveMode == Mode::TimeMachine)
     myOSystem.frameBuffer().showMessage("Time Machine enabled");
@@ -144,6 +383,8 @@ void StateManager::toggleTimeMachine()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StateManager::addExtraState(const string& message)
 {
+  interruptMovie();
+
   if(myActiveMode == Mode::TimeMachine)
   {
     RewindManager& r = myOSystem.state().rewindManager();
@@ -155,6 +396,7 @@ bool StateManager::addExtraState(const string& message)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StateManager::rewindStates(uInt32 numStates)
 {
+  interruptMovie();
   RewindManager& r = myOSystem.state().rewindManager();
   return r.rewindStates(numStates);
 }
@@ -162,6 +404,7 @@ bool StateManager::rewindStates(uInt32 numStates)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StateManager::unwindStates(uInt32 numStates)
 {
+  interruptMovie();
   RewindManager& r = myOSystem.state().rewindManager();
   return r.unwindStates(numStates);
 }
@@ -169,6 +412,7 @@ bool StateManager::unwindStates(uInt32 numStates)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StateManager::windStates(uInt32 numStates, bool unwind)
 {
+  interruptMovie();
   RewindManager& r = myOSystem.state().rewindManager();
   return r.windStates(numStates, unwind);
 }
@@ -179,22 +423,19 @@ void StateManager::update()
   switch(myActiveMode)
   {
     case Mode::TimeMachine:
+      myRewindManager->restoreArchive();
+      myRewindManager->recordInput();
       myRewindManager->addState("Time Machine", true);
       break;
 
-#if 0
     case Mode::MovieRecord:
-      myOSystem.console().controller(Controller::Left).save(myMovieWriter);
-      myOSystem.console().controller(Controller::Right).save(myMovieWriter);
-      myOSystem.console().switches().save(myMovieWriter);
+      recordMovie();
       break;
 
     case Mode::MoviePlayback:
-      myOSystem.console().controller(Controller::Left).load(myMovieReader);
-      myOSystem.console().controller(Controller::Right).load(myMovieReader);
-      myOSystem.console().switches().load(myMovieReader);
+      playMovie();
       break;
-#endif
+
     default:
       break;
   }
@@ -205,6 +446,8 @@ void StateManager::loadState(int slot)
 {
   if(myOSystem.hasConsole())
   {
+    interruptMovie();
+
     if(slot < 0) slot = myCurrentSlot;
 
     ostringstream buf;
@@ -365,25 +608,7 @@ bool StateManager::saveState(Serializer& out)
 void StateManager::reset()
 {
   myRewindManager->clear();
+  stopMovie();
   myActiveMode = myOSystem.settings().getBool(
     myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine") ? Mode::TimeMachine : Mode::Off;
-
-#if 0
-  myCurrentSlot = 0;
-
-  switch(myActiveMode)
-  {
-    case kMovieRecordMode:
-      myMovieWriter.close();
-      break;
-
-    case kMoviePlaybackMode:
-      myMovieReader.close();
-      break;
-
-    default:
-      break;
-  }
-  myActiveMode = kOffMode;
-#endif
 }
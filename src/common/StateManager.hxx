@@ -28,6 +28,13 @@ class RewindManager;
   States can be loaded or saved here, as well as recorded, rewound, and later
   played back.
 
+  Movies record the initial state of the emulation, followed by all changes
+  of the controller and console switch input.  Each change is stored as the
+  bytes which differ from the previous input, keyed to the (delta) system
+  cycle count at which it happened.  Since the input is only polled between
+  the emulation timeslices, the playback ends the timeslices at exactly
+  these cycles (see nextMovieCycles()), making it fully deterministic.
+
   @author  Stephen Anthony
 */
 class StateManager
@@ -52,12 +59,29 @@ class StateManager
     */
     Mode mode() const { return myActiveMode; }
 
-#if 0
     /**
-      Toggle movie recording mode (FIXME - currently disabled)
+      Toggle movie recording mode.  The movie is saved in the state
+      directory, named after the ROM.
     */
     void toggleRecordMode();
-#endif
+
+    /**
+      Toggle movie playback mode, playing the movie of the current ROM.
+    */
+    void togglePlaybackMode();
+
+    /**
+      The system cycle count of the next input change in movie playback mode;
+      the emulation must not run past it before update() is called.
+    */
+    uInt64 nextMovieCycles() const { return myMovieCycles; }
+
+    /**
+      Stop movie recording/playback (if active), since the emulation is
+      about to leave the timeline of the movie (by loading a state, using
+      the Time Machine or entering the debugger).
+    */
+    void interruptMovie();
 
     /**
       Toggle state rewind recording mode; this uses the RewindManager
@@ -146,6 +170,50 @@ class StateManager
     */
     RewindManager& rewindManager() const { return *myRewindManager; }
 
+  private:
+    /**
+      Start recording/playing the movie opened in myMovie, by writing/reading
+      the movie header, initial state and input.
+
+      @return  False on any errors, else true
+    */
+    bool startRecording();
+    bool startPlayback();
+
+    /**
+      Record any input changes since the last call.
+    */
+    void recordMovie();
+
+    /**
+      Apply all input changes up to the current cycles.
+    */
+    void playMovie();
+
+    /**
+      Read the next input change from the movie into myMovieNext (which is
+      emptied at the end of the movie), and its cycles into myMovieCycles.
+
+      @return  False on any errors, else true
+    */
+    bool readMovieInput();
+
+    /**
+      Load the current movie input into the controllers and switches.
+    */
+    void loadMovieInput();
+
+    /**
+      Finish recording/playing a movie (if any), and return to Time Machine
+      mode when enabled.
+    */
+    void stopMovie();
+
+    /**
+      The name of the movie file for the current ROM.
+    */
+    string movieFile() const;
+
   private:
     enum {
       kVersion = 001
@@ -163,9 +231,19 @@ class StateManager
     // MD5 of the currently active ROM (either in movie or rewind mode)
     string myMD5;
 
-    // Serializer classes used to save/load the eventstream
-    Serializer myMovieWriter;
-    Serializer myMovieReader;
+    // The movie being recorded/played back
+    unique_ptr<Serializer> myMovie;
+
+    // Buffer for serializing the input
+    Serializer myInputData;
+
+    // The current input, and the next input (playback only)
+    ByteArray myMovieInput, myMovieNext;
+
+    // System cycle count of the last (recording) or next (playback) input
+    // change, and of the last update (recording)
+    uInt64 myMovieCycles;
+    uInt64 myMovieLastCycles;
 
     // Stored savestates to be later rewound
     unique_ptr<RewindManager> myRewindManager;
@@ -0,0 +1,134 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "ThreadPool.hxx"
+
+namespace {
+  // Number of polls before a waiting thread goes to sleep
+  constexpr uInt32 SPIN_COUNT = 200;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::ThreadPool(uInt32 threads)
+  : myGeneration(0),
+    myPending(0),
+    myJob(nullptr),
+    myJobThreads(1),
+    myQuit(false)
+{
+  resize(threads);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::~ThreadPool()
+{
+  stop();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::resize(uInt32 threads)
+{
+  if (threads == 0) threads = 1;
+  if (threads == size()) return;
+
+  stop();
+
+  // The workers start waiting for the job after the current one, even if
+  // they only get to run after the next run() has started
+  const uInt64 generation = myGeneration.load();
+
+  myQuit = false;
+  for (uInt32 i = 1; i < threads; ++i)
+    myWorkers.emplace_back([this, i, generation] { work(i, generation); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::run(const Job& job)
+{
+  const uInt32 count = size();
+
+  if (count == 1) {
+    job(0, 1);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myJob = &job;
+    myJobThreads = count;
+    myPending = count - 1;
+    ++myGeneration;
+  }
+  myWakeCondition.notify_all();
+
+  job(0, count);
+
+  for (uInt32 i = 0; i < SPIN_COUNT && myPending.load() > 0; ++i)
+    std::this_thread::yield();
+
+  if (myPending.load() > 0) {
+    std::unique_lock<std::mutex> lock(myMutex);
+    myDoneCondition.wait(lock, [this] { return myPending.load() == 0; });
+  }
+
+  myJob = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::work(uInt32 index, uInt64 generation)
+{
+  while (true) {
+    for (uInt32 i = 0; i < SPIN_COUNT && myGeneration.load() == generation; ++i)
+      std::this_thread::yield();
+
+    const Job* job;
+    uInt32 count;
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myWakeCondition.wait(lock, [this, generation] {
+        return myQuit || myGeneration.load() != generation;
+      });
+
+      if (myQuit) return;
+
+      generation = myGeneration.load();
+      job = myJob;
+      count = myJobThreads;
+    }
+
+    (*job)(index, count);
+
+    if (--myPending == 0) {
+      std::lock_guard<std::mutex> lock(myMutex);
+      myDoneCondition.notify_one();
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myWakeCondition.notify_all();
+
+  for (std::thread& worker : myWorkers) worker.join();
+  myWorkers.clear();
+}
@@ -0,0 +1,120 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THREAD_POOL_HXX
+#define THREAD_POOL_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  A fixed set of long-lived worker threads for the per-frame stages which
+  split their work across threads (NTSC filtering, and any other stage
+  that processes a frame row by row).
+
+  The work is dispatched to all threads at once, with the calling thread
+  taking the first share, and run() returns when every thread is done.
+  Workers spin for a short while before sleeping, so stages following each
+  other within a frame don't pay for waking the threads up again.
+
+  The pool is only to be used (and resized) from one thread at a time.
+*/
+class ThreadPool
+{
+  public:
+
+    /**
+      The job to run; called once by each thread with the index of the
+      thread (0 = the calling thread) and the total number of threads.
+    */
+    using Job = std::function<void(uInt32 index, uInt32 count)>;
+
+  public:
+
+    /**
+      Create a pool with the given number of threads (including the one
+      calling run()); 1 runs all jobs directly.
+    */
+    explicit ThreadPool(uInt32 threads = 1);
+    ~ThreadPool();
+
+    /**
+      Stop the current workers and start the given number of threads.
+    */
+    void resize(uInt32 threads);
+
+    /**
+      The number of threads sharing each job, including the calling thread.
+    */
+    uInt32 size() const { return uInt32(myWorkers.size()) + 1; }
+
+    /**
+      Run the job on all threads, and wait for it to finish everywhere.
+    */
+    void run(const Job& job);
+
+    /**
+      The part of 'items' rows the given thread is to process, when these
+      are split evenly across 'count' threads.
+    */
+    static void partition(uInt32 items, uInt32 index, uInt32 count,
+                          uInt32& begin, uInt32& end)
+    {
+      begin = items * index / count;
+      end = items * (index + 1) / count;
+    }
+
+  private:
+
+    void work(uInt32 index, uInt64 generation);
+
+    void stop();
+
+  private:
+
+    vector<std::thread> myWorkers;
+
+    std::mutex myMutex;
+    std::condition_variable myWakeCondition;
+    std::condition_variable myDoneCondition;
+
+    // Incremented for each job; workers run the job when it changes
+    std::atomic<uInt64> myGeneration;
+
+    // Number of workers which haven't finished the current job
+    std::atomic<uInt32> myPending;
+
+    // The current job, and the number of threads sharing it
+    const Job* myJob;
+    uInt32 myJobThreads;
+
+    bool myQuit;
+
+  private:
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+};
+
+#endif // THREAD_POOL_HXX
@@ -0,0 +1,218 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <cmath>
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846f
+#endif
+
+#include "BLEPResampler.hxx"
+
+namespace {
+
+  constexpr float CLIPPING_FACTOR = 0.75;
+  constexpr float HIGH_PASS_CUT_OFF = 10;
+
+  // Cut-off frequency of the steps, relative to the output Nyquist frequency
+  constexpr double CUT_OFF = 0.9;
+
+  double sinc(double x)
+  {
+    return x == 0 ? 1 : sin(M_PI * x) / (M_PI * x);
+  }
+
+  double blackman(double x, double width)
+  {
+    // Blackman window over -width .. width
+    const double t = (x / width + 1) * M_PI;
+    return 0.42 - 0.5 * cos(t) + 0.08 * cos(2 * t);
+  }
+
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BLEPResampler::BLEPResampler(
+  Resampler::Format formatFrom,
+  Resampler::Format formatTo,
+  Resampler::NextFragmentCallback nextFragmentCallback)
+:
+  Resampler(formatFrom, formatTo, nextFragmentCallback),
+  myInputL(0),
+  myInputR(0),
+  myOutputL(0),
+  myOutputR(0),
+  myTimeIndex(0),
+  myAlpha(1.f / (1.f + 2.f*M_PI*HIGH_PASS_CUT_OFF/float(formatTo.sampleRate))),
+  myCurrentFragment(nullptr),
+  myFragmentIndex(0),
+  myIsUnderrun(true)
+{
+  myKernels = make_unique<float[]>(PHASES * KERNEL_SIZE);
+
+  precomputeKernels();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BLEPResampler::precomputeKernels()
+{
+  const double width = KERNEL_SIZE / 2;
+
+  for (uInt32 phase = 0; phase < PHASES; ++phase) {
+    float* kernel = myKernels.get() + phase * KERNEL_SIZE;
+    const double offset = static_cast<double>(phase) / PHASES;
+    double sum = 0;
+
+    // The step happens 'offset' samples after the first output sample of its
+    // kernel, which is centered on the step (delaying the output by half the
+    // kernel)
+    for (uInt32 i = 0; i < KERNEL_SIZE; ++i) {
+      const double x = static_cast<double>(i) + 1 - width - offset;
+      const double value = CUT_OFF * sinc(CUT_OFF * x) * blackman(x, width);
+
+      kernel[i] = static_cast<float>(value);
+      sum += value;
+    }
+
+    // Normalize, so that each step has exactly its height in the end
+    for (uInt32 i = 0; i < KERNEL_SIZE; ++i)
+      kernel[i] = static_cast<float>(kernel[i] / sum);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BLEPResampler::fillFragment(float* fragment, uInt32 length)
+{
+  if (myIsUnderrun) {
+    Int16* nextFragment = myNextFragmentCallback();
+
+    if (nextFragment) {
+      myCurrentFragment = nextFragment;
+      myFragmentIndex = 0;
+      myIsUnderrun = false;
+    }
+  }
+
+  if (!myCurrentFragment) {
+    memset(fragment, 0, sizeof(float) * length);
+    return;
+  }
+
+  const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+
+  if (myBufferL.size() < outputSamples + KERNEL_SIZE) {
+    myBufferL.resize(outputSamples + KERNEL_SIZE);
+    if (myFormatFrom.stereo) myBufferR.resize(outputSamples + KERNEL_SIZE);
+  }
+
+  const uInt32 rateFrom = scaledRateFrom();
+
+  addSteps(outputSamples, rateFrom);
+
+  // Integrate the steps; the leak of the integrator is the high pass which
+  // removes any DC offset.  The steps are in units of the 16-bit input, so
+  // conversion and volume are applied here.
+  float* bufferL = myBufferL.data();
+  float* bufferR = myBufferR.data();
+  const float gain = outputGain();
+
+  for (uInt32 i = 0; i < outputSamples; ++i) {
+    myOutputL = myAlpha * (myOutputL + bufferL[i]);
+
+    if (myFormatFrom.stereo) {
+      myOutputR = myAlpha * (myOutputR + bufferR[i]);
+
+      if (myFormatTo.stereo) {
+        fragment[2*i] = myOutputL * gain;
+        fragment[2*i + 1] = myOutputR * gain;
+      }
+      else
+        fragment[i] = (myOutputL + myOutputR) * (gain / 2.f);
+    } else {
+      if (myFormatTo.stereo)
+        fragment[2*i] = fragment[2*i + 1] = myOutputL * gain;
+      else
+        fragment[i] = myOutputL * gain;
+    }
+  }
+
+  // Keep the tails of the last steps for the next fragment
+  memmove(bufferL, bufferL + outputSamples, KERNEL_SIZE * sizeof(float));
+  memset(bufferL + KERNEL_SIZE, 0, outputSamples * sizeof(float));
+  if (myFormatFrom.stereo) {
+    memmove(bufferR, bufferR + outputSamples, KERNEL_SIZE * sizeof(float));
+    memset(bufferR + KERNEL_SIZE, 0, outputSamples * sizeof(float));
+  }
+  myTimeIndex -= uInt64(outputSamples) * rateFrom;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BLEPResampler::addSteps(uInt32 outputSamples, uInt32 rateFrom)
+{
+  const uInt64 end = uInt64(outputSamples) * rateFrom;
+  const uInt32 rateTo = scaledRateTo();
+  const float scale = CLIPPING_FACTOR;
+
+  while (myTimeIndex < end) {
+    // On underruns, the input level is held
+    if (!nextSample()) {
+      myTimeIndex = end;
+      break;
+    }
+
+    const uInt32 index = uInt32(myTimeIndex / rateFrom);
+    const float* kernel = myKernels.get() + KERNEL_SIZE *
+      uInt32((myTimeIndex % rateFrom) * PHASES / rateFrom);
+
+    if (myFormatFrom.stereo) {
+      const Int16 sampleL = myCurrentFragment[2*myFragmentIndex];
+      const Int16 sampleR = myCurrentFragment[2*myFragmentIndex + 1];
+
+      if (sampleL != myInputL) addStep(myBufferL.data(), index, kernel, (sampleL - myInputL) * scale);
+      if (sampleR != myInputR) addStep(myBufferR.data(), index, kernel, (sampleR - myInputR) * scale);
+      myInputL = sampleL;
+      myInputR = sampleR;
+    } else {
+      const Int16 sample = myCurrentFragment[myFragmentIndex];
+
+      if (sample != myInputL) addStep(myBufferL.data(), index, kernel, (sample - myInputL) * scale);
+      myInputL = sample;
+    }
+
+    ++myFragmentIndex;
+
+    // Each input sample lasts rateTo / rateFrom output samples
+    myTimeIndex += rateTo;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BLEPResampler::nextSample()
+{
+  if (myFragmentIndex < myFormatFrom.fragmentSize && !myIsUnderrun)
+    return true;
+
+  Int16* nextFragment = myNextFragmentCallback();
+  if (nextFragment) {
+    myCurrentFragment = nextFragment;
+    myFragmentIndex = 0;
+    myIsUnderrun = false;
+  } else
+    myIsUnderrun = true;
+
+  return !myIsUnderrun;
+}
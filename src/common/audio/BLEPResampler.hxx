@@ -0,0 +1,117 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef BLEP_RESAMPLER_HXX
+#define BLEP_RESAMPLER_HXX
+
+#include "bspf.hxx"
+#include "Resampler.hxx"
+
+/**
+  Resamples the TIA audio by band-limited step (BLEP) synthesis.
+
+  The TIA output is a step signal which only changes at the TIA audio
+  clock, so instead of convoluting every output sample with the input
+  samples, each change of the input is added to the output as a
+  band-limited step (a windowed sinc impulse, placed with sub-sample
+  precision, which is integrated afterwards).  The cost per output sample
+  is one integration step, which doubles as the DC blocking high pass;
+  only transitions cost a short convolution, and most TIA waveforms have
+  far fewer of those than output samples.  The long kernel cuts off
+  close to the output Nyquist frequency, rejecting aliases better than
+  the Lanczos kernels.
+*/
+class BLEPResampler : public Resampler
+{
+  public:
+    BLEPResampler(
+      Resampler::Format formatFrom,
+      Resampler::Format formatTo,
+      Resampler::NextFragmentCallback nextFragmentCallback
+    );
+
+    void fillFragment(float* fragment, uInt32 length) override;
+
+    virtual ~BLEPResampler() = default;
+
+  private:
+
+    // Number of output samples covered by each step, and number of sub-sample
+    // positions the steps are precomputed for
+    static constexpr uInt32 KERNEL_SIZE = 16;
+    static constexpr uInt32 PHASES = 64;
+
+    void precomputeKernels();
+
+    /**
+      Add the input samples up to the end of the output fragment as steps.
+
+      @param outputSamples  The number of output samples in the fragment
+      @param rateFrom       The scaled input sample rate for this fragment
+    */
+    void addSteps(uInt32 outputSamples, uInt32 rateFrom);
+
+    /**
+      Get the next input sample (pair), advancing to the next fragment
+      when necessary.
+
+      @return  False on underruns, else true
+    */
+    bool nextSample();
+
+    /**
+      Add a step of the given height at the given position.
+    */
+    void addStep(float* buffer, uInt32 index, const float* kernel, float delta) {
+      for (uInt32 i = 0; i < KERNEL_SIZE; ++i) buffer[index + i] += kernel[i] * delta;
+    }
+
+  private:
+
+    // The band-limited impulses for all phases
+    unique_ptr<float[]> myKernels;
+
+    // The steps added to the next output samples (two channels for stereo input)
+    vector<float> myBufferL, myBufferR;
+
+    // The current input level, and the output level (after integration)
+    Int16 myInputL, myInputR;
+    float myOutputL, myOutputR;
+
+    // Time of the next input sample, relative to the start of the buffer,
+    // in units of 1 / scaledRateFrom() output samples
+    uInt64 myTimeIndex;
+
+    // Pole of the integrator (a high pass with a low cut-off frequency)
+    float myAlpha;
+
+    Int16* myCurrentFragment;
+    uInt32 myFragmentIndex;
+    bool myIsUnderrun;
+
+  private:
+
+    BLEPResampler() = delete;
+    BLEPResampler(const BLEPResampler&) = delete;
+    BLEPResampler(BLEPResampler&&) = delete;
+    BLEPResampler& operator=(const BLEPResampler&) = delete;
+    BLEPResampler& operator=(BLEPResampler&&) = delete;
+
+};
+
+#endif // BLEP_RESAMPLER_HXX
@@ -15,32 +15,156 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#if defined(__AVX__)
+  #include <immintrin.h>
+  #define CONVOLUTION_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #include <xmmintrin.h>
+  #define CONVOLUTION_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define CONVOLUTION_NEON
+#endif
+
 #include "ConvolutionBuffer.hxx"
 
+namespace {
+
+#if defined(CONVOLUTION_AVX)
+  constexpr uInt32 VECTOR_SIZE = 8;
+
+  inline float horizontalSum(__m256 v)
+  {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+  }
+#elif defined(CONVOLUTION_SSE)
+  constexpr uInt32 VECTOR_SIZE = 4;
+
+  inline float horizontalSum(__m128 s)
+  {
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+  }
+#elif defined(CONVOLUTION_NEON)
+  constexpr uInt32 VECTOR_SIZE = 4;
+
+  inline float horizontalSum(float32x4_t v)
+  {
+    float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+  }
+#else
+  constexpr uInt32 VECTOR_SIZE = 1;
+#endif
+
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ConvolutionBuffer::ConvolutionBuffer(uInt32 size)
   : myFirstIndex(0),
-    mySize(size)
+    mySize(size),
+    myPaddedSize(paddedSize(size))
+{
+  // The mirrored samples, plus room for the padding of the last window
+  myData = make_unique<float[]>(mySize + myPaddedSize);
+  memset(myData.get(), 0, (mySize + myPaddedSize) * sizeof(float));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ConvolutionBuffer::paddedSize(uInt32 size)
 {
-  myData = make_unique<float[]>(mySize);
-  memset(myData.get(), 0, mySize * sizeof(float));
+  return (size + VECTOR_SIZE - 1) / VECTOR_SIZE * VECTOR_SIZE;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ConvolutionBuffer::shift(float nextValue)
 {
-  myData[myFirstIndex] = nextValue;
-  myFirstIndex = (myFirstIndex + 1) % mySize;
+  myData[myFirstIndex] = myData[myFirstIndex + mySize] = nextValue;
+  if (++myFirstIndex == mySize) myFirstIndex = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-float ConvolutionBuffer::convoluteWith(float* kernel) const
+float ConvolutionBuffer::convoluteWith(const float* kernel) const
 {
+  const float* data = myData.get() + myFirstIndex;
+
+#if defined(CONVOLUTION_AVX)
+  __m256 sum = _mm256_setzero_ps();
+  for (uInt32 i = 0; i < myPaddedSize; i += VECTOR_SIZE)
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(kernel + i), _mm256_loadu_ps(data + i)));
+
+  return horizontalSum(sum);
+#elif defined(CONVOLUTION_SSE)
+  __m128 sum = _mm_setzero_ps();
+  for (uInt32 i = 0; i < myPaddedSize; i += VECTOR_SIZE)
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(kernel + i), _mm_loadu_ps(data + i)));
+
+  return horizontalSum(sum);
+#elif defined(CONVOLUTION_NEON)
+  float32x4_t sum = vdupq_n_f32(0.f);
+  for (uInt32 i = 0; i < myPaddedSize; i += VECTOR_SIZE)
+    sum = vmlaq_f32(sum, vld1q_f32(kernel + i), vld1q_f32(data + i));
+
+  return horizontalSum(sum);
+#else
   float result = 0.;
 
-  for (uInt32 i = 0; i < mySize; ++i) {
-    result += kernel[i] * myData[(myFirstIndex + i) % mySize];
-  }
+  for (uInt32 i = 0; i < mySize; ++i)
+    result += kernel[i] * data[i];
 
   return result;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConvolutionBuffer::convoluteWith(const float* kernel,
+                                      const ConvolutionBuffer& left, const ConvolutionBuffer& right,
+                                      float& resultL, float& resultR)
+{
+  const float* dataL = left.myData.get() + left.myFirstIndex;
+  const float* dataR = right.myData.get() + right.myFirstIndex;
+  const uInt32 size = left.myPaddedSize;
+
+#if defined(CONVOLUTION_AVX)
+  __m256 sumL = _mm256_setzero_ps(), sumR = _mm256_setzero_ps();
+  for (uInt32 i = 0; i < size; i += VECTOR_SIZE) {
+    const __m256 k = _mm256_loadu_ps(kernel + i);
+    sumL = _mm256_add_ps(sumL, _mm256_mul_ps(k, _mm256_loadu_ps(dataL + i)));
+    sumR = _mm256_add_ps(sumR, _mm256_mul_ps(k, _mm256_loadu_ps(dataR + i)));
+  }
+  resultL = horizontalSum(sumL);
+  resultR = horizontalSum(sumR);
+#elif defined(CONVOLUTION_SSE)
+  __m128 sumL = _mm_setzero_ps(), sumR = _mm_setzero_ps();
+  for (uInt32 i = 0; i < size; i += VECTOR_SIZE) {
+    const __m128 k = _mm_loadu_ps(kernel + i);
+    sumL = _mm_add_ps(sumL, _mm_mul_ps(k, _mm_loadu_ps(dataL + i)));
+    sumR = _mm_add_ps(sumR, _mm_mul_ps(k, _mm_loadu_ps(dataR + i)));
+  }
+  // Reduce both sums at once: (L0 + L2, R0 + R2, L1 + L3, R1 + R3)
+  __m128 sum = _mm_add_ps(_mm_unpacklo_ps(sumL, sumR), _mm_unpackhi_ps(sumL, sumR));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  resultL = _mm_cvtss_f32(sum);
+  resultR = _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, 0x55));
+#elif defined(CONVOLUTION_NEON)
+  float32x4_t sumL = vdupq_n_f32(0.f), sumR = vdupq_n_f32(0.f);
+  for (uInt32 i = 0; i < size; i += VECTOR_SIZE) {
+    const float32x4_t k = vld1q_f32(kernel + i);
+    sumL = vmlaq_f32(sumL, k, vld1q_f32(dataL + i));
+    sumR = vmlaq_f32(sumR, k, vld1q_f32(dataR + i));
+  }
+  resultL = horizontalSum(sumL);
+  resultR = horizontalSum(sumR);
+#else
+  resultL = resultR = 0.;
+
+  for (uInt32 i = 0; i < size; ++i) {
+    resultL += kernel[i] * dataL[i];
+    resultR += kernel[i] * dataR[i];
+  }
+#endif
 }
@@ -20,6 +20,15 @@
 
 #include "bspf.hxx"
 
+/**
+  A ring buffer of the last 'size' samples, convoluted with a kernel for
+  each output sample.
+
+  Each sample is stored twice (mirrored at an offset of 'size'), so the
+  samples always form a contiguous window, which is convoluted without any
+  index wrapping, using SSE/AVX/NEON where available.  The vector loads
+  read up to paddedSize() values; kernels must be zero padded to that size.
+*/
 class ConvolutionBuffer
 {
   public:
@@ -28,7 +37,21 @@ class ConvolutionBuffer
 
     void shift(float nextValue);
 
-    float convoluteWith(float* kernel) const;
+    float convoluteWith(const float* kernel) const;
+
+    /**
+      Convolute the left and right channel buffers (which must be of the
+      same size) with the same kernel, in one pass.
+    */
+    static void convoluteWith(const float* kernel,
+                              const ConvolutionBuffer& left, const ConvolutionBuffer& right,
+                              float& resultL, float& resultR);
+
+    /**
+      The kernel size (including the zero padding) needed for a buffer
+      of the given size.
+    */
+    static uInt32 paddedSize(uInt32 size);
 
   private:
 
@@ -38,6 +61,8 @@ class ConvolutionBuffer
 
     uInt32 mySize;
 
+    uInt32 myPaddedSize;
+
   private:
 
     ConvolutionBuffer() = delete;
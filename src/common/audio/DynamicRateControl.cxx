@@ -0,0 +1,62 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "DynamicRateControl.hxx"
+
+namespace {
+
+  // Time constant of the fill level smoothing; this should cover the bursts of
+  // the emulation (which produces a frame of audio at once)
+  constexpr double SMOOTHING_TIME = 0.5;
+
+  // Time constant of the control loop (in seconds); the integral time is
+  // chosen such that the loop is critically damped
+  constexpr double CONVERGENCE_TIME = 4;
+
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DynamicRateControl::DynamicRateControl(uInt32 sampleRate, uInt32 fragmentSize,
+                                       double updateRate, uInt32 target)
+  : mySmoothing(1. / (SMOOTHING_TIME * updateRate + 1)),
+    // A rate adjustment of 1 drains the queue by sampleRate / fragmentSize
+    // fragments per second
+    myProportionalGain(double(fragmentSize) / (double(sampleRate) * CONVERGENCE_TIME)),
+    myIntegralGain(myProportionalGain / (4 * CONVERGENCE_TIME * updateRate)),
+    myTarget(target),
+    myFill(target),
+    myIntegral(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double DynamicRateControl::update(uInt32 fill)
+{
+  myFill += mySmoothing * (double(fill) - myFill);
+
+  const double error = myFill - myTarget;
+  const double adjustment = myProportionalGain * error + myIntegralGain * (myIntegral + error);
+
+  // Stop integrating while saturated, the integral would only wind up
+  if (adjustment > MAX_ADJUSTMENT) return MAX_ADJUSTMENT;
+  if (adjustment < -MAX_ADJUSTMENT) return -MAX_ADJUSTMENT;
+
+  myIntegral += error;
+
+  return adjustment;
+}
@@ -0,0 +1,85 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef DYNAMIC_RATE_CONTROL_HXX
+#define DYNAMIC_RATE_CONTROL_HXX
+
+#include "bspf.hxx"
+
+/**
+  Keeps the fill level of the audio queue close to a (small) target by
+  slightly adjusting the resampling ratio.
+
+  The emulation is paced by the host timer, and the audio device by its own
+  clock; as these never run at exactly the same speed, a fixed ratio lets the
+  queue slowly fill up (adding latency until fragments are dropped) or drain
+  (until it underruns), which large buffers can only delay.  Instead, the
+  smoothed fill level drives a PI controller, which nudges the rate at which
+  input samples are consumed by at most MAX_ADJUSTMENT, far below what is
+  audible as a change of pitch.
+*/
+class DynamicRateControl
+{
+  public:
+
+    /**
+      Create a new controller.
+
+      @param sampleRate    The sample rate of the queued audio (in Hz)
+      @param fragmentSize  The number of samples per queued fragment
+      @param updateRate    The number of updates per second
+      @param target        The fill level to converge to (in fragments)
+    */
+    DynamicRateControl(uInt32 sampleRate, uInt32 fragmentSize,
+                       double updateRate, uInt32 target);
+
+    /**
+      Update the controller with the current fill level of the queue.
+
+      @param fill  The number of fragments in the queue
+      @return  The new rate adjustment for the resampler
+    */
+    double update(uInt32 fill);
+
+    // Maximum relative change of the resampling ratio
+    static constexpr double MAX_ADJUSTMENT = 0.005;
+
+  private:
+
+    // Time constant of the fill level smoothing (in updates)
+    double mySmoothing;
+
+    // Proportional and integral gain (per fragment, and per fragment and update)
+    double myProportionalGain;
+    double myIntegralGain;
+
+    double myTarget;
+
+    double myFill;
+    double myIntegral;
+
+  private:
+
+    DynamicRateControl() = delete;
+    DynamicRateControl(const DynamicRateControl&) = delete;
+    DynamicRateControl(DynamicRateControl&&) = delete;
+    DynamicRateControl& operator=(const DynamicRateControl&) = delete;
+    DynamicRateControl& operator=(DynamicRateControl&&) = delete;
+};
+
+#endif // DYNAMIC_RATE_CONTROL_HXX
@@ -27,6 +27,11 @@ namespace {
   constexpr float CLIPPING_FACTOR = 0.75;
   constexpr float HIGH_PASS_CUT_OFF = 10;
 
+  // Minimum number of kernels (phases) to precompute; if the sample rates have
+  // a large common divisor, the exact ratio needs only a few, but a slightly
+  // adjusted rate needs a finer resolution
+  constexpr uInt32 MIN_KERNEL_COUNT = 128;
+
   uInt32 reducedDenominator(uInt32 n, uInt32 d)
   {
     for (uInt32 i = std::min(n ,d); i > 1; --i) {
@@ -40,6 +45,15 @@ namespace {
     return d;
   }
 
+  uInt32 kernelCount(uInt32 n, uInt32 d)
+  {
+    const uInt32 exactCount = reducedDenominator(n, d);
+
+    // Keep a multiple of the exact count, so that the exact ratio still hits
+    // the kernels precisely
+    return exactCount * ((MIN_KERNEL_COUNT + exactCount - 1) / exactCount);
+  }
+
   float sinc(float x)
   {
     // We calculate the sinc with double precision in order to compensate for precision loss
@@ -72,9 +86,9 @@ LanczosResampler::LanczosResampler(
   // formatFrom.sampleRate / formatTo.sampleRate = M / N
   //
   // -> we find N from fully reducing the fraction.
-  myPrecomputedKernelCount(reducedDenominator(formatFrom.sampleRate, formatTo.sampleRate)),
+  myPrecomputedKernelCount(kernelCount(formatFrom.sampleRate, formatTo.sampleRate)),
   myKernelSize(2 * kernelParameter),
-  myCurrentKernelIndex(0),
+  myPaddedKernelSize(ConvolutionBuffer::paddedSize(myKernelSize)),
   myKernelParameter(kernelParameter),
   myCurrentFragment(nullptr),
   myFragmentIndex(0),
@@ -84,7 +98,8 @@ LanczosResampler::LanczosResampler(
   myHighPass(HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)),
   myTimeIndex(0)
 {
-  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelSize);
+  // The kernels are zero padded for the vectorized convolution
+  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myPaddedKernelSize);
 
   if (myFormatFrom.stereo)
   {
@@ -100,33 +115,24 @@ LanczosResampler::LanczosResampler(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LanczosResampler::precomputeKernels()
 {
-  // timeIndex = time * formatFrom.sampleRate * formatTo.sampleRAte
-  uInt32 timeIndex = 0;
-
+  // The kernels are ordered by the time since the last input sample: kernel i
+  // is centered at i / myPrecomputedKernelCount input samples. With the exact
+  // ratio of the sample rates, time only takes these values, as
+  //
+  // time = N / formatFrom.sampleRate + delta
+  //
+  // with N integral and delta a multiple of 1 / formatTo.sampleRate.
   for (uInt32 i = 0; i < myPrecomputedKernelCount; ++i) {
-    float* kernel = myPrecomputedKernels.get() + myKernelSize * i;
+    float* kernel = myPrecomputedKernels.get() + myPaddedKernelSize * i;
     // The kernel is normalized such to be evaluate on time * formatFrom.sampleRate
     float center =
-      static_cast<float>(timeIndex) / static_cast<float>(myFormatTo.sampleRate);
+      static_cast<float>(i) / static_cast<float>(myPrecomputedKernelCount);
 
     for (uInt32 j = 0; j < 2 * myKernelParameter; ++j) {
       kernel[j] = lanczosKernel(
           center - static_cast<float>(j) + static_cast<float>(myKernelParameter) - 1.f, myKernelParameter
         ) * CLIPPING_FACTOR;
     }
-
-    // Next step: time += 1 / formatTo.sampleRate
-    //
-    // By construction, we limit the argument during kernel evaluation to 0 .. 1, which
-    // corresponds to 0 .. 1 / formatFrom.sampleRate for time. To implement this, we decompose
-    // time as follows:
-    //
-    // time = N / formatFrom.sampleRate + delta
-    // timeIndex = N * formatTo.sampleRate + delta * formatTo.sampleRate * formatFrom.sampleRate
-    //
-    // with N integral and delta < 0. From this, it follows that we replace
-    // time with delta, i.e. take the modulus of timeIndex.
-    timeIndex = (timeIndex + myFormatFrom.sampleRate) % myFormatTo.sampleRate;
   }
 }
 
@@ -149,14 +155,24 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
   }
 
   const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+  const uInt32 rateFrom = scaledRateFrom(), rateTo = scaledRateTo();
+
+  // The buffers hold the (high passed) raw 16-bit samples; conversion and
+  // volume are applied to the convolution result
+  const float gain = outputGain();
 
+  // myTimeIndex = delta * rateFrom * rateTo, with delta the time since the last
+  // input sample (see above)
   for (uInt32 i = 0; i < outputSamples; ++i) {
-    float* kernel = myPrecomputedKernels.get() + (myCurrentKernelIndex * myKernelSize);
-    myCurrentKernelIndex = (myCurrentKernelIndex + 1) % myPrecomputedKernelCount;
+    const uInt32 kernelIndex =
+      static_cast<uInt32>(uInt64(myTimeIndex) * myPrecomputedKernelCount / rateTo);
+    const float* kernel = myPrecomputedKernels.get() + (kernelIndex * myPaddedKernelSize);
 
     if (myFormatFrom.stereo) {
-      float sampleL = myBufferL->convoluteWith(kernel);
-      float sampleR = myBufferR->convoluteWith(kernel);
+      float sampleL, sampleR;
+      ConvolutionBuffer::convoluteWith(kernel, *myBufferL, *myBufferR, sampleL, sampleR);
+      sampleL *= gain;
+      sampleR *= gain;
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -165,7 +181,7 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
       else
         fragment[i] = (sampleL + sampleR) / 2.f;
     } else {
-      float sample = myBuffer->convoluteWith(kernel);
+      float sample = myBuffer->convoluteWith(kernel) * gain;
 
       if (myFormatTo.stereo)
         fragment[2*i] = fragment[2*i + 1] = sample;
@@ -173,12 +189,13 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
         fragment[i] = sample;
     }
 
-    myTimeIndex += myFormatFrom.sampleRate;
+    // time += 1 / formatTo.sampleRate
+    myTimeIndex += rateFrom;
 
-    uInt32 samplesToShift = myTimeIndex / myFormatTo.sampleRate;
+    uInt32 samplesToShift = myTimeIndex / rateTo;
     if (samplesToShift == 0) continue;
 
-    myTimeIndex %= myFormatTo.sampleRate;
+    myTimeIndex %= rateTo;
     shiftSamples(samplesToShift);
   }
 }
@@ -188,11 +205,11 @@ inline void LanczosResampler::shiftSamples(uInt32 samplesToShift)
 {
   while (samplesToShift-- > 0) {
     if (myFormatFrom.stereo) {
-      myBufferL->shift(myHighPassL.apply(myCurrentFragment[2*myFragmentIndex] / static_cast<float>(0x7fff)));
-      myBufferR->shift(myHighPassR.apply(myCurrentFragment[2*myFragmentIndex + 1] / static_cast<float>(0x7fff)));
+      myBufferL->shift(myHighPassL.apply(static_cast<float>(myCurrentFragment[2*myFragmentIndex])));
+      myBufferR->shift(myHighPassR.apply(static_cast<float>(myCurrentFragment[2*myFragmentIndex + 1])));
     }
     else
-      myBuffer->shift(myHighPass.apply(myCurrentFragment[myFragmentIndex] / static_cast<float>(0x7fff)));
+      myBuffer->shift(myHighPass.apply(static_cast<float>(myCurrentFragment[myFragmentIndex])));
 
     ++myFragmentIndex;
 
@@ -204,7 +221,6 @@ inline void LanczosResampler::shiftSamples(uInt32 samplesToShift)
         myCurrentFragment = nextFragment;
         myIsUnderrun = false;
       } else {
-        (cerr << "audio buffer underrun\n").flush();
         myIsUnderrun = true;
       }
     }
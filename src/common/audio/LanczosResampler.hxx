@@ -47,7 +47,7 @@ class LanczosResampler : public Resampler
 
     uInt32 myPrecomputedKernelCount;
     uInt32 myKernelSize;
-    uInt32 myCurrentKernelIndex;
+    uInt32 myPaddedKernelSize;
     unique_ptr<float[]> myPrecomputedKernels;
 
     uInt32 myKernelParameter;
@@ -19,6 +19,7 @@
 #define RESAMPLER_HXX
 
 #include <functional>
+#include <cmath>
 
 #include "bspf.hxx"
 
@@ -52,11 +53,30 @@ class Resampler {
     Resampler(Format formatFrom, Format formatTo, NextFragmentCallback nextFragmentCallback) :
       myFormatFrom(formatFrom),
       myFormatTo(formatTo),
-      myNextFragmentCallback(nextFragmentCallback)
+      myNextFragmentCallback(nextFragmentCallback),
+      myRateAdjustment(0),
+      myVolume(1)
     {}
 
     virtual void fillFragment(float* fragment, uInt32 length) = 0;
 
+    /**
+      Nudge the ratio between input and output sample rate; the input is
+      consumed as if its sample rate was (1 + adjustment) times the nominal
+      one.  Takes effect with the next fragment.
+
+      @param adjustment  The relative change of the input sample rate
+    */
+    void adjustRate(double adjustment) { myRateAdjustment = adjustment; }
+
+    /**
+      Set the volume of the output.  Scaling is part of the conversion of the
+      16-bit input, so the output needs no separate pass.
+
+      @param volume  The volume factor (1 = full volume)
+    */
+    void setVolume(float volume) { myVolume = volume; }
+
     virtual ~Resampler() {}
 
   protected:
@@ -66,6 +86,35 @@ class Resampler {
 
     NextFragmentCallback myNextFragmentCallback;
 
+    /**
+      The (adjusted) input sample rate, in units of 1 / RATE_SCALE Hz.
+    */
+    uInt32 scaledRateFrom() const {
+      return static_cast<uInt32>(
+        std::round(double(myFormatFrom.sampleRate) * RATE_SCALE * (1 + myRateAdjustment))
+      );
+    }
+
+    /**
+      The output sample rate, in units of 1 / RATE_SCALE Hz.
+    */
+    uInt32 scaledRateTo() const { return myFormatTo.sampleRate * RATE_SCALE; }
+
+    /**
+      The factor mapping 16-bit input samples to output samples, including
+      the volume.
+    */
+    float outputGain() const { return myVolume / static_cast<float>(0x7fff); }
+
+    // Fixed point resolution of the sample rates used for timing
+    static constexpr uInt32 RATE_SCALE = 1 << 10;
+
+  private:
+
+    double myRateAdjustment;
+
+    float myVolume;
+
   private:
 
     Resampler() = delete;
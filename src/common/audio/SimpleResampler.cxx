@@ -49,12 +49,14 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
   }
 
   const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+  const uInt32 rateFrom = scaledRateFrom(), rateTo = scaledRateTo();
+  const float gain = outputGain();
 
-  // For the following math, remember that myTimeIndex = time * myFormatFrom.sampleRate * myFormatTo.sampleRate
+  // For the following math, remember that myTimeIndex = time * rateFrom * rateTo
   for (uInt32 i = 0; i < outputSamples; ++i) {
     if (myFormatFrom.stereo) {
-      float sampleL = static_cast<float>(myCurrentFragment[2*myFragmentIndex]) / static_cast<float>(0x7fff);
-      float sampleR = static_cast<float>(myCurrentFragment[2*myFragmentIndex + 1]) / static_cast<float>(0x7fff);
+      float sampleL = static_cast<float>(myCurrentFragment[2*myFragmentIndex]) * gain;
+      float sampleR = static_cast<float>(myCurrentFragment[2*myFragmentIndex + 1]) * gain;
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -63,7 +65,7 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
       else
         fragment[i] = (sampleL + sampleR) / 2.f;
     } else {
-      float sample = static_cast<float>(myCurrentFragment[myFragmentIndex] / static_cast<float>(0x7fff));
+      float sample = static_cast<float>(myCurrentFragment[myFragmentIndex]) * gain;
 
       if (myFormatTo.stereo)
         fragment[2*i] = fragment[2*i + 1] = sample;
@@ -71,14 +73,14 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
         fragment[i] = sample;
     }
 
-    // time += 1 / myFormatTo.sampleRate
-    myTimeIndex += myFormatFrom.sampleRate;
+    // time += 1 / rateTo
+    myTimeIndex += rateFrom;
 
-    // time >= 1 / myFormatFrom.sampleRate
-    if (myTimeIndex >= myFormatTo.sampleRate) {
-      // myFragmentIndex += time * myFormatFrom.sampleRate
-      myFragmentIndex += myTimeIndex / myFormatTo.sampleRate;
-      myTimeIndex %= myFormatTo.sampleRate;
+    // time >= 1 / rateFrom
+    if (myTimeIndex >= rateTo) {
+      // myFragmentIndex += time * rateFrom
+      myFragmentIndex += myTimeIndex / rateTo;
+      myTimeIndex %= rateTo;
     }
 
     if (myFragmentIndex >= myFormatFrom.fragmentSize) {
@@ -88,7 +90,6 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
       if (nextFragment)
         myCurrentFragment = nextFragment;
       else {
-        (cerr << "audio buffer underrun\n").flush();
         myIsUnderrun = true;
       }
     }
@@ -4,6 +4,8 @@ MODULE_OBJS := \
 	src/common/audio/SimpleResampler.o \
 	src/common/audio/ConvolutionBuffer.o \
 	src/common/audio/LanczosResampler.o \
+	src/common/audio/BLEPResampler.o \
+	src/common/audio/DynamicRateControl.o \
 	src/common/audio/HighPass.o
 
 MODULE_DIRS += \
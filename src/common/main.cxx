@@ -96,6 +96,17 @@ int main(int argc, char* argv[])
 
     return Cleanup();
   }
+  else if(theOSystem->settings().getString("renderaudio") != "")
+  {
+    theOSystem->logMessage("Rendering audio with 'renderaudio' ...", 2);
+    FilesystemNode romnode(romfile);
+    const double seconds = theOSystem->settings().getFloat("rendertime");
+    const bool rendered = theOSystem->renderAudio(romnode,
+        theOSystem->settings().getString("renderaudio"), seconds > 0 ? seconds : 60);
+
+    Cleanup();
+    return rendered ? 0 : 1;
+  }
   else if(theOSystem->settings().getBool("help"))
   {
     theOSystem->logMessage("Displaying usage", 2);
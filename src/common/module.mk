@@ -13,11 +13,14 @@ MODULE_OBJS := \
 	src/common/PKeyboardHandler.o \
 	src/common/PNGLibrary.o \
 	src/common/RewindManager.o \
+	src/common/StateArchive.o \
 	src/common/SoundSDL2.o \
 	src/common/StateManager.o \
+	src/common/ThreadPool.o \
 	src/common/TimerManager.o \
 	src/common/ZipHandler.o \
 	src/common/AudioQueue.o \
+	src/common/AudioStats.o \
 	src/common/AudioSettings.o \
 	src/common/FpsMeter.o
 
@@ -15,7 +15,18 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
-#include <thread>
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define NTSC_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define NTSC_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define NTSC_NEON
+#endif
+
+#include "ThreadPool.hxx"
 #include "AtariNTSC.hxx"
 
 // blitter related
@@ -66,46 +77,22 @@ void AtariNTSC::initializePalette(const uInt8* palette)
   }
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::enableThreading(bool enable)
-{
-  uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 0;
-  if(systemThreads <= 1)
-  {
-    myWorkerThreads = 0;
-    myTotalThreads  = 1;
-  }
-  else
-  {
-    systemThreads = std::min(4u, systemThreads);
-
-    myWorkerThreads = systemThreads - 1;
-    myTotalThreads  = systemThreads;
-
-    myThreads = make_unique<std::thread[]>(myWorkerThreads);
-  }
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::render(const uInt8* atari_in, const uInt32 in_width, const uInt32 in_height,
   void* rgb_out, const uInt32 out_pitch, uInt32* rgb_in)
 {
-  // Spawn the threads...
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-  {
-    myThreads[i] = std::thread([=] {
+  const ThreadPool::Job job = [=](uInt32 threadNum, uInt32 numThreads) {
     rgb_in == nullptr ?
-      renderThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_out, out_pitch) :
-      renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_in, rgb_out, out_pitch);
-    });
-  }
-  // Make the main thread busy too
-  rgb_in == nullptr ?
-    renderThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_out, out_pitch) :
-    renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_in, rgb_out, out_pitch);
-  // ...and make them join again
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-    myThreads[i].join();
+      renderThread(atari_in, in_width, in_height, numThreads, threadNum, rgb_out, out_pitch) :
+      renderWithPhosphorThread(atari_in, in_width, in_height, numThreads, threadNum, rgb_in, rgb_out, out_pitch);
+  };
+
+  // The calling thread renders the first part, the workers of the pool
+  // (if any) the rest
+  if(myThreadPool)
+    myThreadPool->run(job);
+  else
+    job(0, 1);
 
   // Copy phosphor values into out buffer
   if(rgb_in != nullptr)
@@ -123,60 +110,9 @@ void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
   atari_in += in_width * yStart;
   rgb_out  = static_cast<char*>(rgb_out) + out_pitch * yStart;
 
-  uInt32 const chunk_count = (in_width - 1) / PIXEL_in_chunk;
-
   for(uInt32 y = yStart; y < yEnd; ++y)
   {
-    const uInt8* line_in = atari_in;
-    ATARI_NTSC_BEGIN_ROW(NTSC_black, line_in[0]);
-    uInt32* restrict line_out = static_cast<uInt32*>(rgb_out);
-    ++line_in;
-
-    for(uInt32 n = chunk_count; n; --n)
-    {
-      // order of input and output pixels must not be altered
-      ATARI_NTSC_COLOR_IN(0, line_in[0]);
-      ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
-      ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
-      ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
-      ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
-
-      ATARI_NTSC_COLOR_IN(1, line_in[1]);
-      ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
-      ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
-      ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
-
-      line_in += 2;
-      line_out += 7;
-    }
-
-    // finish final pixels
-    ATARI_NTSC_COLOR_IN(0, line_in[0]);
-    ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
-    ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
-    ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
-    ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
-
-    ATARI_NTSC_COLOR_IN(1, NTSC_black);
-    ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
-    ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
-    ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
-
-    line_in += 2;
-    line_out += 7;
-
-    ATARI_NTSC_COLOR_IN(0, NTSC_black);
-    ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
-    ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
-    ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
-    ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
-
-    ATARI_NTSC_COLOR_IN(1, NTSC_black);
-    ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
-#if 0
-    ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
-    ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
-#endif
+    renderLine(atari_in, in_width, static_cast<uInt32*>(rgb_out));
 
     atari_in += in_width;
     rgb_out = static_cast<char*>(rgb_out) + out_pitch;
@@ -196,60 +132,9 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
   atari_in += in_width * yStart;
   rgb_out = static_cast<char*>(rgb_out) + out_pitch * yStart;
 
-  uInt32 const chunk_count = (in_width - 1) / PIXEL_in_chunk;
-
   for(uInt32 y = yStart; y < yEnd; ++y)
   {
-    const uInt8* line_in = atari_in;
-    ATARI_NTSC_BEGIN_ROW(NTSC_black, line_in[0]);
-    uInt32* restrict line_out = static_cast<uInt32*>(rgb_out);
-    ++line_in;
-
-    for(uInt32 n = chunk_count; n; --n)
-    {
-      // order of input and output pixels must not be altered
-      ATARI_NTSC_COLOR_IN(0, line_in[0]);
-      ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
-      ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
-      ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
-      ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
-
-      ATARI_NTSC_COLOR_IN(1, line_in[1]);
-      ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
-      ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
-      ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
-
-      line_in += 2;
-      line_out += 7;
-    }
-
-    // finish final pixels
-    ATARI_NTSC_COLOR_IN(0, line_in[0]);
-    ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
-    ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
-    ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
-    ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
-
-    ATARI_NTSC_COLOR_IN(1, NTSC_black);
-    ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
-    ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
-    ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
-
-    line_in += 2;
-    line_out += 7;
-
-    ATARI_NTSC_COLOR_IN(0, NTSC_black);
-    ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
-    ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
-    ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
-    ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
-
-    ATARI_NTSC_COLOR_IN(1, NTSC_black);
-    ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
-#if 0
-    ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
-    ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
-#endif
+    renderLine(atari_in, in_width, static_cast<uInt32*>(rgb_out));
 
     // Do phosphor mode (blend the resulting frames)
     // Note: The code assumes that AtariNTSC::outWidth(kTIAW) == outPitch == 565
@@ -296,6 +181,202 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::renderLine(const uInt8* line_in, const uInt32 in_width,
+  uInt32* restrict line_out) const
+{
+  uInt32 const chunk_count = (in_width - 1) / PIXEL_in_chunk;
+
+  ATARI_NTSC_BEGIN_ROW(NTSC_black, line_in[0]);
+  ++line_in;
+
+  if(mySIMD)
+  {
+    for(uInt32 n = chunk_count; n; --n)
+    {
+      // Same as below, with the 7 output pixels computed at once
+      uInt32 const* const kernelx1Last = kernelx1;
+      kernelx0 = kernel0;
+      kernel0 = myColorTable[line_in[0]];
+      kernelx1 = kernel1;
+      kernel1 = myColorTable[line_in[1]];
+      renderChunk(kernel0, kernelx1, kernel1, kernelx0, kernelx1Last, line_out);
+
+      line_in += 2;
+      line_out += 7;
+    }
+  }
+  else
+  {
+    for(uInt32 n = chunk_count; n; --n)
+    {
+      // order of input and output pixels must not be altered
+      ATARI_NTSC_COLOR_IN(0, line_in[0]);
+      ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
+      ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
+      ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
+      ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
+
+      ATARI_NTSC_COLOR_IN(1, line_in[1]);
+      ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
+      ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
+      ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
+
+      line_in += 2;
+      line_out += 7;
+    }
+  }
+
+  // finish final pixels
+  ATARI_NTSC_COLOR_IN(0, line_in[0]);
+  ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
+  ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
+  ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
+  ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
+
+  ATARI_NTSC_COLOR_IN(1, NTSC_black);
+  ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
+  ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
+  ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
+
+  line_in += 2;
+  line_out += 7;
+
+  ATARI_NTSC_COLOR_IN(0, NTSC_black);
+  ATARI_NTSC_RGB_OUT_8888(0, line_out[0]);
+  ATARI_NTSC_RGB_OUT_8888(1, line_out[1]);
+  ATARI_NTSC_RGB_OUT_8888(2, line_out[2]);
+  ATARI_NTSC_RGB_OUT_8888(3, line_out[3]);
+
+  ATARI_NTSC_COLOR_IN(1, NTSC_black);
+  ATARI_NTSC_RGB_OUT_8888(4, line_out[4]);
+#if 0
+  ATARI_NTSC_RGB_OUT_8888(5, line_out[5]);
+  ATARI_NTSC_RGB_OUT_8888(6, line_out[6]);
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::enableSIMD(bool enable)
+{
+#if defined(NTSC_AVX2) || defined(NTSC_SSE2) || defined(NTSC_NEON)
+  mySIMD = enable;
+#else
+  mySIMD = false;
+  (void)enable;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* AtariNTSC::simd()
+{
+#if defined(NTSC_AVX2)
+  return "AVX2";
+#elif defined(NTSC_SSE2)
+  return "SSE2";
+#elif defined(NTSC_NEON)
+  return "NEON";
+#else
+  return "none";
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void AtariNTSC::renderChunk(uInt32 const* kernel0, uInt32 const* kernel1,
+  uInt32 const* kernel1Next, uInt32 const* kernelx0, uInt32 const* kernelx1,
+  uInt32* restrict line_out)
+{
+  // Output pixels 0..3 are the sum of
+  //   kernel0[0..3], kernel1[17..20], kernelx0[7..10], kernelx1[24..27]
+  // and pixels 4..6 (plus one more, which is overwritten by the next chunk)
+  //   kernel0[4..7], kernel1Next[14..17], kernelx0[11..14], kernel1[21..24]
+  // exactly like ATARI_NTSC_RGB_OUT_8888 does; clamping and packing work on
+  // each 32-bit lane separately, so the result is identical.
+#if defined(NTSC_AVX2)
+  const __m256i raw = _mm256_add_epi32(
+    _mm256_add_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kernel0)),
+      _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kernel1 + 17))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(kernel1Next + 14)), 1)),
+    _mm256_add_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kernelx0 + 7)),
+      _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kernelx1 + 24))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(kernel1 + 21)), 1)));
+
+  const __m256i sub = _mm256_and_si256(_mm256_srli_epi32(raw, 9),
+                                       _mm256_set1_epi32(atari_ntsc_clamp_mask));
+  __m256i clamp = _mm256_sub_epi32(_mm256_set1_epi32(atari_ntsc_clamp_add), sub);
+  __m256i clamped = _mm256_or_si256(raw, clamp);
+  clamp = _mm256_sub_epi32(clamp, sub);
+  clamped = _mm256_and_si256(clamped, clamp);
+
+  const __m256i rgb = _mm256_or_si256(
+    _mm256_or_si256(
+      _mm256_and_si256(_mm256_srli_epi32(clamped, 5), _mm256_set1_epi32(0x00FF0000)),
+      _mm256_and_si256(_mm256_srli_epi32(clamped, 3), _mm256_set1_epi32(0x0000FF00))),
+    _mm256_and_si256(_mm256_srli_epi32(clamped, 1), _mm256_set1_epi32(0x000000FF)));
+
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(line_out), rgb);
+#elif defined(NTSC_SSE2)
+  const auto load = [](uInt32 const* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  };
+  const auto output = [](__m128i raw, uInt32* out) {
+    const __m128i sub = _mm_and_si128(_mm_srli_epi32(raw, 9),
+                                      _mm_set1_epi32(atari_ntsc_clamp_mask));
+    __m128i clamp = _mm_sub_epi32(_mm_set1_epi32(atari_ntsc_clamp_add), sub);
+    raw = _mm_or_si128(raw, clamp);
+    clamp = _mm_sub_epi32(clamp, sub);
+    raw = _mm_and_si128(raw, clamp);
+
+    const __m128i rgb = _mm_or_si128(
+      _mm_or_si128(
+        _mm_and_si128(_mm_srli_epi32(raw, 5), _mm_set1_epi32(0x00FF0000)),
+        _mm_and_si128(_mm_srli_epi32(raw, 3), _mm_set1_epi32(0x0000FF00))),
+      _mm_and_si128(_mm_srli_epi32(raw, 1), _mm_set1_epi32(0x000000FF)));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), rgb);
+  };
+
+  output(_mm_add_epi32(_mm_add_epi32(load(kernel0), load(kernel1 + 17)),
+                       _mm_add_epi32(load(kernelx0 + 7), load(kernelx1 + 24))),
+         line_out);
+  output(_mm_add_epi32(_mm_add_epi32(load(kernel0 + 4), load(kernel1Next + 14)),
+                       _mm_add_epi32(load(kernelx0 + 11), load(kernel1 + 21))),
+         line_out + 4);
+#elif defined(NTSC_NEON)
+  const auto output = [](uint32x4_t raw, uInt32* out) {
+    const uint32x4_t sub = vandq_u32(vshrq_n_u32(raw, 9),
+                                     vdupq_n_u32(atari_ntsc_clamp_mask));
+    uint32x4_t clamp = vsubq_u32(vdupq_n_u32(atari_ntsc_clamp_add), sub);
+    raw = vorrq_u32(raw, clamp);
+    clamp = vsubq_u32(clamp, sub);
+    raw = vandq_u32(raw, clamp);
+
+    const uint32x4_t rgb = vorrq_u32(
+      vorrq_u32(
+        vandq_u32(vshrq_n_u32(raw, 5), vdupq_n_u32(0x00FF0000)),
+        vandq_u32(vshrq_n_u32(raw, 3), vdupq_n_u32(0x0000FF00))),
+      vandq_u32(vshrq_n_u32(raw, 1), vdupq_n_u32(0x000000FF)));
+
+    vst1q_u32(out, rgb);
+  };
+
+  output(vaddq_u32(vaddq_u32(vld1q_u32(kernel0), vld1q_u32(kernel1 + 17)),
+                   vaddq_u32(vld1q_u32(kernelx0 + 7), vld1q_u32(kernelx1 + 24))),
+         line_out);
+  output(vaddq_u32(vaddq_u32(vld1q_u32(kernel0 + 4), vld1q_u32(kernel1Next + 14)),
+                   vaddq_u32(vld1q_u32(kernelx0 + 11), vld1q_u32(kernel1 + 21))),
+         line_out + 4);
+#else
+  // Never used, see enableSIMD()
+  (void)kernel0; (void)kernel1; (void)kernel1Next;
+  (void)kernelx0; (void)kernelx1; (void)line_out;
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline uInt32 AtariNTSC::getRGBPhosphor(const uInt32 c, const uInt32 p) const
 {
@@ -41,10 +41,11 @@
 #define ATARI_NTSC_HXX
 
 #include <cmath>
-#include <thread>
 
 #include "bspf.hxx"
 
+class ThreadPool;
+
 class AtariNTSC
 {
   public:
@@ -53,8 +54,8 @@ class AtariNTSC
       entry_size = 2 * 14,
     };
 
-    // By default, threading is turned off
-    AtariNTSC() { enableThreading(false); }
+    // By default, threading is turned off, and SIMD code (if available) is used
+    AtariNTSC() : myThreadPool(nullptr) { enableSIMD(true); }
 
     // Image parameters, ranging from -1.0 to 1.0. Actual internal values shown
     // in parenthesis and should remain fairly stable in future versions.
@@ -85,8 +86,16 @@ class AtariNTSC
     void initialize(const Setup& setup, const uInt8* palette);
     void initializePalette(const uInt8* palette);
 
-    // Set up threading
-    void enableThreading(bool enable);
+    // Set up threading; rows are split across the threads of the pool
+    // (nullptr renders on the calling thread only)
+    void setThreadPool(ThreadPool* pool) { myThreadPool = pool; }
+
+    // Use the vectorized (SSE2, AVX2 or NEON) kernels, if compiled in;
+    // otherwise (or when disabled), the scalar reference code is used
+    void enableSIMD(bool enable);
+
+    // The instruction set of the vectorized kernels ("none" if unavailable)
+    static const char* simd();
 
     // Set phosphor palette, for use in Blargg + phosphor mode
     void setPhosphorPalette(uInt8 palette[256][256]) {
@@ -115,6 +124,15 @@ class AtariNTSC
     }
 
   private:
+    // Render one row of input pixels
+    void renderLine(const uInt8* line_in, const uInt32 in_width, uInt32* line_out) const;
+
+    // Vectorized equivalent of ATARI_NTSC_RGB_OUT_8888 for the 7 output
+    // pixels of a chunk (8 are written; see the implementation)
+    static void renderChunk(uInt32 const* kernel0, uInt32 const* kernel1,
+      uInt32 const* kernel1Next, uInt32 const* kernelx0, uInt32 const* kernelx1,
+      uInt32* line_out);
+
     // Threaded rendering
     void renderThread(const uInt8* atari_in, const uInt32 in_width,
       const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum, void* rgb_out, const uInt32 out_pitch);
@@ -171,9 +189,10 @@ class AtariNTSC
     uInt8 myPhosphorPalette[256][256];
 
     // Rendering threads
-    unique_ptr<std::thread[]> myThreads;
-    // Number of rendering and total threads
-    uInt32 myWorkerThreads, myTotalThreads;
+    ThreadPool* myThreadPool;
+
+    // Use the vectorized kernels
+    bool mySIMD;
 
     struct init_t
     {
@@ -120,10 +120,10 @@ class NTSCFilter
       myNTSC.render(src_buf, src_width, src_height, dest_buf, dest_pitch, prev_buf);
     }
 
-    // Enable threading for the NTSC rendering
-    inline void enableThreading(bool enable)
+    // Use the given thread pool for the NTSC rendering
+    inline void setThreadPool(ThreadPool* pool)
     {
-      myNTSC.enableThreading(enable);
+      myNTSC.setThreadPool(pool);
     }
 
   private:
@@ -0,0 +1,208 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "TIA.hxx"
+#include "EmulationTiming.hxx"
+#include "DispatchResult.hxx"
+#include "AudioQueue.hxx"
+#include "AudioRenderer.hxx"
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration;
+
+namespace {
+  // Store a value in little-endian byte order, as used by WAV files
+  void putLE(char* buf, uInt32 value, uInt32 bytes)
+  {
+    for(uInt32 i = 0; i < bytes; ++i, value >>= 8)
+      buf[i] = char(value & 0xff);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioRenderer::AudioRenderer(OSystem& osystem)
+  : myOSystem(osystem),
+    myDone(false),
+    myLastSamples(0),
+    myDataSize(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioRenderer::~AudioRenderer()
+{
+  myDone = true;
+  if(myWriter.joinable())
+    myWriter.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool AudioRenderer::render(Console& console, const string& filename, double seconds)
+{
+  TIA& tia = console.tia();
+  EmulationTiming& timing = console.emulationTiming();
+
+  myFile.open(filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if(!myFile.is_open())
+  {
+    myOSystem.logMessage("ERROR: Couldn't create audio file " + filename, 0);
+    return false;
+  }
+
+  // Enough room for the audio of a frame (plus partially filled fragments)
+  const uInt32 frameFragments =
+    timing.cyclesPerFrame() / 38 / timing.audioFragmentSize() + 2;
+
+  myAudioQueue = console.redirectAudio(QUEUE_FRAMES * frameFragments);
+  myAudioQueue->ignoreOverflows(false);
+
+  // The sizes are filled in when done
+  writeHeader(timing.audioSampleRate(), 0);
+
+  myDone = false;
+  myLastSamples = 0;
+  myDataSize = 0;
+  myWriter = std::thread(&AudioRenderer::writeFragments, this);
+
+  const auto start = high_resolution_clock::now();
+  const uInt64 startCycles = tia.cycles();
+  const uInt64 endCycles = startCycles + uInt64(seconds * timing.cyclesPerSecond());
+  DispatchResult result;
+  bool success = true;
+
+  while(tia.cycles() < endCycles)
+  {
+    // Wait until the writer has made room for another frame
+    while(myAudioQueue->size() + frameFragments > myAudioQueue->capacity())
+      std::this_thread::yield();
+
+    tia.update(result, std::min(uInt64(timing.cyclesPerFrame()), endCycles - tia.cycles()));
+    if(result.getStatus() != DispatchResult::Status::ok)
+    {
+      myOSystem.logMessage("ERROR: Emulation stopped while rendering audio", 0);
+      success = false;
+      break;
+    }
+  }
+
+  // The end of the audio is still in the TIA
+  myLastSamples = tia.flushAudio();
+  myDone = true;
+  myWriter.join();
+
+  const duration<double> elapsed = high_resolution_clock::now() - start;
+
+  // Now that the size is known, complete the header
+  myFile.seekp(0);
+  writeHeader(timing.audioSampleRate(), uInt32(std::min(myDataSize, uInt64(0xffffffff - 36))));
+  myFile.close();
+
+  if(myFile.fail())
+  {
+    myOSystem.logMessage("ERROR: Couldn't write audio file " + filename, 0);
+    success = false;
+  }
+  else if(myAudioQueue->overflows() > 0)
+  {
+    myOSystem.logMessage("ERROR: Audio fragments were dropped while rendering", 0);
+    success = false;
+  }
+
+  ostringstream buf;
+  const double emulated = double(tia.cycles() - startCycles) / timing.cyclesPerSecond();
+  buf << "Rendered " << std::fixed << std::setprecision(1) << emulated
+      << " seconds of audio to " << filename << " in " << elapsed.count()
+      << " seconds (" << std::setprecision(0) << emulated / elapsed.count() << "x realtime)";
+  myOSystem.logMessage(buf.str(), 1);
+
+  myAudioQueue.reset();
+
+  return success;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioRenderer::writeFragments()
+{
+  const uInt32 samples = myAudioQueue->fragmentSize() * (myAudioQueue->isStereo() ? 2 : 1);
+  unique_ptr<char[]> buf = make_unique<char[]>(samples * 2);
+  Int16* fragment = nullptr;
+  bool pending = false;
+
+  for(;;)
+  {
+    // Check for the end first, so that all fragments queued before are written
+    const bool done = myDone;
+    Int16* nextFragment = myAudioQueue->dequeue(fragment);
+
+    if(!nextFragment)
+    {
+      if(done) break;
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    fragment = nextFragment;
+
+    // Each fragment is written when the next one arrives, since only the
+    // last one may be incomplete
+    if(pending)
+      writeSamples(buf.get(), samples);
+
+    for(uInt32 i = 0; i < samples; ++i)
+      putLE(buf.get() + 2 * i, uInt16(fragment[i]), 2);
+    pending = true;
+  }
+
+  if(pending)
+    writeSamples(buf.get(), myLastSamples > 0
+      ? myLastSamples * (myAudioQueue->isStereo() ? 2 : 1) : samples);
+
+  myAudioQueue->closeSink(fragment);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioRenderer::writeSamples(const char* buf, uInt32 samples)
+{
+  myFile.write(buf, samples * 2);
+  myDataSize += samples * 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioRenderer::writeHeader(uInt32 sampleRate, uInt32 dataSize)
+{
+  const uInt32 channels = myAudioQueue->isStereo() ? 2 : 1;
+  char header[44];
+
+  memcpy(header, "RIFF", 4);
+  putLE(header + 4, 36 + dataSize, 4);
+  memcpy(header + 8, "WAVEfmt ", 8);
+  putLE(header + 16, 16, 4);                          // size of format chunk
+  putLE(header + 20, 1, 2);                           // PCM
+  putLE(header + 22, channels, 2);
+  putLE(header + 24, sampleRate, 4);
+  putLE(header + 28, sampleRate * channels * 2, 4);   // bytes per second
+  putLE(header + 32, channels * 2, 2);                // bytes per sample frame
+  putLE(header + 34, 16, 2);                          // bits per sample
+  memcpy(header + 36, "data", 4);
+  putLE(header + 40, dataSize, 4);
+
+  myFile.write(header, 44);
+}
@@ -0,0 +1,114 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef AUDIO_RENDERER_HXX
+#define AUDIO_RENDERER_HXX
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+class OSystem;
+class Console;
+class AudioQueue;
+
+#include "bspf.hxx"
+
+/**
+  Renders the audio of a console to a WAV file, as fast as possible
+  instead of in real time (e.g. for regression testing of music
+  drivers, by comparing the files).
+
+  The emulation runs on the calling thread, without any pacing; the TIA
+  writes into a dedicated (large) audio queue, which a worker thread drains
+  into the file.  The emulation only waits when the queue could not take
+  another frame of audio, so no fragment is ever dropped.  The raw TIA
+  samples are written (16 bit, at the TIA sample rate), so the result does
+  not depend on the audio settings.  When done, the partly filled last
+  fragment is flushed, and only its valid samples are written.
+
+  The console is meant to be a temporary one, without framebuffer and
+  sound (see OSystem::renderAudio()); its audio stays redirected.
+*/
+class AudioRenderer
+{
+  public:
+    AudioRenderer(OSystem& osystem);
+    ~AudioRenderer();
+
+  public:
+    /**
+      Run the console for the given amount of emulated time, writing its
+      audio to the given file.
+
+      @param console   The console to run
+      @param filename  The name of the WAV file
+      @param seconds   The emulated time to render
+      @return  False on any errors, else true
+    */
+    bool render(Console& console, const string& filename, double seconds);
+
+  private:
+    /**
+      Drain the audio queue into the file until the emulation is done
+      (runs on the worker thread).
+    */
+    void writeFragments();
+
+    /**
+      Write the given number of (converted) samples of a fragment.
+    */
+    void writeSamples(const char* buf, uInt32 samples);
+
+    /**
+      Write the WAV header for the given amount of sample data.
+    */
+    void writeHeader(uInt32 sampleRate, uInt32 dataSize);
+
+  private:
+    // Number of frames of audio the queue holds
+    static constexpr uInt32 QUEUE_FRAMES = 16;
+
+    OSystem& myOSystem;
+
+    shared_ptr<AudioQueue> myAudioQueue;
+
+    std::ofstream myFile;
+
+    // The worker thread, writing the fragments to the file
+    std::thread myWriter;
+
+    // Set when the emulation has finished
+    std::atomic<bool> myDone;
+
+    // Samples in the flushed last fragment (0 if that one is complete);
+    // set before myDone
+    uInt32 myLastSamples;
+
+    // Bytes of sample data written (only accessed by the worker while it runs)
+    uInt64 myDataSize;
+
+  private:
+    // Following constructors and assignment operators not supported
+    AudioRenderer() = delete;
+    AudioRenderer(const AudioRenderer&) = delete;
+    AudioRenderer(AudioRenderer&&) = delete;
+    AudioRenderer& operator=(const AudioRenderer&) = delete;
+    AudioRenderer& operator=(AudioRenderer&&) = delete;
+};
+
+#endif
@@ -71,7 +71,7 @@ class Cartridge : public Device
       the banks before querying the cart state, otherwise reading values
       could inadvertantly cause a bankswitch to occur.
     */
-    void lockBank()   { myBankLocked = true;  }
+    virtual void lockBank()   { myBankLocked = true;  }
     void unlockBank() { myBankLocked = false; }
     bool bankLocked() const { return myBankLocked; }
 
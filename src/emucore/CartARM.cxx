@@ -0,0 +1,410 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifdef DEBUGGER_SUPPORT
+  #include "Debugger.hxx"
+#endif
+#include "System.hxx"
+#include "Thumbulator.hxx"
+#include "CartARM.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartridgeARM::CartridgeARM(const Settings& settings)
+  : Cartridge(settings),
+    myDisplayImage(nullptr),
+    myARMCycles(0),
+    myThreadedARM(settings.getBool("armthread")),
+    myTrapOverrun(false),
+    myARMDuration(0),
+    myWorstOverrun(0),
+    myARMPending(false),
+    myARMIrqAudio(false),
+    myARMBusy(false),
+    myARMQuit(false),
+    myARMRunCycles(0),
+    myDatastreamPointerBase(0),
+    myDatastreamIncrementBase(0),
+    myDatastreamCount(0),
+    myDatastreamsCached(false)
+{
+  memset(myRAM, 0, 8192);
+
+  for(int i = 0; i < 3; ++i)
+  {
+    myMusicCounters[i] = myMusicFrequencies[i] = 0;
+    myMusicWaveformSize[i] = 27;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartridgeARM::~CartridgeARM()
+{
+  if(myARMThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(myARMMutex);
+      myARMQuit = true;
+    }
+    myARMCondition.notify_all();
+    myARMThread.join();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::createThumbulator(const uInt8* rom,
+                                     Thumbulator::ConfigureFor configurefor)
+{
+  const string& prefix = mySettings.getBool("dev.settings") ? "dev." : "plr.";
+  myTrapOverrun = mySettings.getBool(prefix + "thumb.trapoverrun");
+  myThumbEmulator = make_unique<Thumbulator>(
+    reinterpret_cast<const uInt16*>(rom), reinterpret_cast<uInt16*>(myRAM),
+    mySettings.getBool(prefix + "thumb.trapfatal"), configurefor, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::resetARM()
+{
+  joinARM();
+  myARMPending = false;
+  myARMIrqAudio = false;
+
+  myThumbEmulator->resetPeripherals();
+  myMusicClock.reset();
+  myARMCycles = 0;
+  myARMDuration = 0;
+
+  // The driver (and thus the datastreams) will be re-initialized in RAM
+  myDatastreamsCached = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::consoleChanged(ConsoleTiming timing)
+{
+  joinARM();
+  myThumbEmulator->setConsoleTiming(timing);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::runARM(bool irqAudio)
+{
+  // Only one call into the ARM code can be active at any time
+  syncARM();
+
+  // The ARM code works on the datastreams in RAM
+  flushDatastreams(myRAM);
+  myDatastreamsCached = false;
+
+  Int32 cycles = Int32(mySystem->cycles() - myARMCycles);
+  myARMCycles = mySystem->cycles();
+  myARMPending = true;
+  myARMIrqAudio = irqAudio;
+
+  // During autodetection, the ARM code is run synchronously, since the
+  // cart may be destroyed again right away
+  if(myThreadedARM && !mySystem->autodetectMode())
+    startARM(cycles);
+  else
+  {
+    executeARM(cycles);
+    reportARMError();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::executeARM(Int32 cycles)
+{
+  try {
+    myThumbEmulator->run(cycles);
+    myARMDuration = myThumbEmulator->cycles6507();
+  }
+  catch(const runtime_error& e) {
+    myARMError = e.what();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::startARM(Int32 cycles)
+{
+  if(!myARMThread.joinable())
+    myARMThread = std::thread([this] { armThreadMain(); });
+
+  {
+    std::lock_guard<std::mutex> lock(myARMMutex);
+    myARMRunCycles = cycles;
+    myARMBusy = true;
+  }
+  myARMCondition.notify_all();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::armThreadMain()
+{
+  std::unique_lock<std::mutex> lock(myARMMutex);
+
+  while(true)
+  {
+    myARMCondition.wait(lock, [this] { return myARMQuit || myARMBusy; });
+    if(myARMQuit)
+      return;
+
+    const Int32 cycles = myARMRunCycles;
+    lock.unlock();
+    executeARM(cycles);
+    lock.lock();
+
+    myARMBusy = false;
+    myARMCondition.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::checkARMOverrun(uInt32 elapsed) const
+{
+  if(myARMDuration <= elapsed || mySystem->autodetectMode())
+    return;
+
+  ostringstream buf;
+  buf << "ARM code overrun: the last call takes ~" << myARMDuration
+      << " 6507 cycles, but its results were accessed after " << elapsed;
+
+  if(myTrapOverrun)
+  {
+#ifdef DEBUGGER_SUPPORT
+    Debugger::debugger().start(buf.str());
+#else
+    cout << buf.str() << endl;
+#endif
+  }
+  else if(myARMDuration - elapsed > myWorstOverrun)
+  {
+    // Only log overruns larger than those seen before
+    myWorstOverrun = myARMDuration - elapsed;
+    cout << buf.str() << endl;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::finishARM() const
+{
+  joinARM();
+  myARMPending = false;
+
+  checkARMOverrun(uInt32(mySystem->cycles() - myARMCycles));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::joinARM() const
+{
+  if(!myARMBusy)
+    return;
+
+  // The 6507 is usually parked in ROM until the ARM code is done, so the
+  // call has most likely finished already; spin shortly before sleeping
+  for(int i = 0; i < 200 && myARMBusy; ++i)
+    std::this_thread::yield();
+
+  {
+    std::unique_lock<std::mutex> lock(myARMMutex);
+    myARMCondition.wait(lock, [this] { return !myARMBusy; });
+  }
+  reportARMError();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::reportARMError() const
+{
+  if(myARMError.empty())
+    return;
+
+  if(!mySystem->autodetectMode())
+  {
+#ifdef DEBUGGER_SUPPORT
+    Debugger::debugger().startWithFatalError(myARMError);
+#else
+    cout << myARMError << endl;
+#endif
+  }
+  myARMError = "";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::lockBank()
+{
+  // The debugger inspecting the cart doesn't count as an access by the 6507
+  joinARM();
+  myARMPending = false;
+
+  // The debugger accesses the datastreams in RAM while the bank is locked
+  flushDatastreams(myRAM);
+  myDatastreamsCached = false;
+
+  Cartridge::lockBank();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::setDatastreamLocation(uInt16 pointers, uInt16 increments,
+                                         uInt8 count)
+{
+  myDatastreamPointerBase = pointers;
+  myDatastreamIncrementBase = increments;
+  myDatastreamCount = std::min(count, uInt8(MAX_DATASTREAMS));
+  myDatastreamsCached = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::loadDatastreams()
+{
+  for(uInt8 i = 0; i < myDatastreamCount; ++i)
+  {
+    myDatastreamPointers[i] = getRAMWord(myDatastreamPointerBase + i * 4);
+    myDatastreamIncrements[i] = getRAMWord(myDatastreamIncrementBase + i * 4);
+  }
+  myDatastreamsCached = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeARM::flushDatastreams(uInt8* ram) const
+{
+  if(!myDatastreamsCached)
+    return;
+
+  auto putWord = [ram](uInt16 address, uInt32 value) {
+    ram[address + 0] = value & 0xff;          // low byte
+    ram[address + 1] = (value >> 8) & 0xff;
+    ram[address + 2] = (value >> 16) & 0xff;
+    ram[address + 3] = (value >> 24) & 0xff;  // high byte
+  };
+
+  for(uInt8 i = 0; i < myDatastreamCount; ++i)
+  {
+    putWord(myDatastreamPointerBase + i * 4, myDatastreamPointers[i]);
+    putWord(myDatastreamIncrementBase + i * 4, myDatastreamIncrements[i]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 CartridgeARM::readFromUncachedDatastream(uInt8 index)
+{
+  uInt32 pointer = getDatastreamPointer(index);
+  uInt16 increment = getDatastreamIncrement(index);
+  uInt8 value = myDisplayImage[ pointer >> 20 ];
+  pointer += (increment << 12);
+  setDatastreamPointer(index, pointer);
+  return value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeARM::thumbCallback(uInt8 function, uInt32 value1, uInt32 value2)
+{
+  switch (function)
+  {
+    case 0:
+      // _SetNote - set the note/frequency
+      myMusicFrequencies[value1] = value2;
+      break;
+
+      // _ResetWave - reset counter,
+      // used to make sure digital samples start from the beginning
+    case 1:
+      myMusicCounters[value1] = 0;
+      break;
+
+      // _GetWavePtr - return the counter
+    case 2:
+      return myMusicCounters[value1];
+
+      // _SetWaveSize - set size of waveform buffer
+    case 3:
+      myMusicWaveformSize[value1] = value2;
+      break;
+  }
+
+  return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeARM::save(Serializer& out) const
+{
+  joinARM();
+
+  try
+  {
+    // Harmony RAM, including any cached datastreams
+    if(myDatastreamsCached)
+    {
+      uInt8 ram[8192];
+      memcpy(ram, myRAM, 8192);
+      flushDatastreams(ram);
+      out.putByteArray(ram, 8192);
+    }
+    else
+      out.putByteArray(myRAM, 8192);
+
+    // Audio info
+    out.putIntArray(myMusicCounters, 3);
+    out.putIntArray(myMusicFrequencies, 3);
+    out.putByteArray(myMusicWaveformSize, 3);
+
+    // Clock info for the music data fetchers
+    if(!myMusicClock.save(out)) return false;
+
+    // Clock info for Thumbulator
+    out.putLong(myARMCycles);
+    out.putInt(myThumbEmulator->mamMode());
+  }
+  catch(...)
+  {
+    cerr << "ERROR: " << name() << "::save" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeARM::load(Serializer& in)
+{
+  joinARM();
+  myARMPending = false;
+
+  try
+  {
+    // Harmony RAM
+    in.getByteArray(myRAM, 8192);
+    myDatastreamsCached = false;
+
+    // Audio info
+    in.getIntArray(myMusicCounters, 3);
+    in.getIntArray(myMusicFrequencies, 3);
+    in.getByteArray(myMusicWaveformSize, 3);
+
+    // Clock info for the music data fetchers
+    if(!myMusicClock.load(in)) return false;
+
+    // Clock info for Thumbulator
+    myARMCycles = in.getLong();
+    myThumbEmulator->setMamMode(in.getInt());
+    myARMDuration = 0;
+  }
+  catch(...)
+  {
+    cerr << "ERROR: " << name() << "::load" << endl;
+    return false;
+  }
+
+  return true;
+}
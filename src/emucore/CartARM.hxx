@@ -0,0 +1,461 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CARTRIDGE_ARM_HXX
+#define CARTRIDGE_ARM_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "System.hxx"
+#include "Cart.hxx"
+#include "MusicClock.hxx"
+#include "Thumbulator.hxx"
+
+/**
+  This is the abstract cartridge class for the Harmony/Melody based
+  schemes (DPC+, CDF and BUS), where a 6507 program is assisted by an
+  ARM coprocessor.
+
+  It owns the parts all these schemes have in common:
+    - the 8K Harmony RAM (driver, display data and C variables/stack)
+    - the Thumbulator ARM emulator and the logic to call into it
+    - the three music mode data fetchers and the clock driving them
+    - the 32-bit datastream pointers/increments which the ARM driver
+      keeps in RAM (used by CDF and BUS)
+
+  Any work on the ARM emulation or the datastream engine should go here,
+  so that all schemes benefit from it.
+
+  Each call into the ARM code is checked against the cycle estimate of
+  the Thumbulator: when the ARM code would still be running on real
+  hardware by the time the 6507 first accesses its results, this is
+  reported (entering the debugger when 'thumb.trapoverrun' is enabled).
+  When the ARM code is called with IRQ driven audio, the driver keeps
+  serving AMPLITUDE while it runs, so reading the audio doesn't count as
+  such an access (see syncAudio()).
+
+  Optionally ('armthread' setting), the ARM code runs on a dedicated worker
+  thread (started with the first call, and kept for the lifetime of the
+  cart) while the 6507 and TIA continue to be emulated.  In any mode, the derived
+  classes must call syncARM() before touching any state the ARM code may
+  modify (RAM, datastreams, music fetchers); the 6507 is typically parked
+  in a loop in ROM while the ARM code is running, so this rarely blocks.
+
+  @authors  Darrell Spice Jr, Chris Walton, Fred Quimby,
+            Stephen Anthony, Bradford W. Mott
+*/
+class CartridgeARM : public Cartridge
+{
+  public:
+    /**
+      Create a new ARM based cartridge
+
+      @param settings  A reference to the various settings (read-only)
+    */
+    CartridgeARM(const Settings& settings);
+    virtual ~CartridgeARM();
+
+  public:
+    /**
+      Notification method invoked by the system when the console type
+      has changed.  We need this to inform the Thumbulator that the
+      timing has changed.
+
+      @param timing  Enum representing the new console type
+    */
+    void consoleChanged(ConsoleTiming timing) override;
+
+    /**
+      Save the ARM related state of this cart to the given Serializer.
+
+      @param out  The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool save(Serializer& out) const override;
+
+    /**
+      Load the ARM related state of this cart from the given Serializer.
+
+      @param in  The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool load(Serializer& in) override;
+
+    /**
+      Used for Thumbulator to pass values back to the cartridge; these
+      emulate the 32-bit audio routines of the BUS and CDF drivers.
+    */
+    uInt32 thumbCallback(uInt8 function, uInt32 value1, uInt32 value2) override;
+
+    /**
+      The debugger locks the banks before querying the cart state, so
+      any running ARM code must finish first, and the datastreams must
+      be visible in RAM.
+    */
+    void lockBank() override;
+
+  protected:
+    /**
+      Create the Thumbulator ARM emulator, running from the given ROM
+      and using the internal Harmony RAM.
+
+      @param rom            Pointer to the (32K) ROM image
+      @param configurefor   The cartridge scheme the ARM code is written for
+    */
+    void createThumbulator(const uInt8* rom,
+                           Thumbulator::ConfigureFor configurefor);
+
+    /**
+      Reset the ARM and music related clocks to their power-on state.
+    */
+    void resetARM();
+
+    /**
+      Run the ARM code until it returns control to the 6507, reporting
+      any fatal errors to the debugger (or the console).  In threaded
+      mode, this only starts the ARM code; see syncARM().
+
+      @param irqAudio  The ARM driver serves the audio (by IRQ) while the
+                       ARM code runs
+    */
+    void runARM(bool irqAudio);
+
+    /**
+      Called before the first access to the results of the last ARM call:
+      wait for ARM code running in a separate thread (if any) to finish,
+      report any fatal errors that occurred in the meantime, and check
+      whether the ARM code would have finished on real hardware by now.
+    */
+    void syncARM() const { if(myARMPending) finishARM(); }
+
+    /**
+      Like syncARM(), but for reading the audio (AMPLITUDE), which doesn't
+      access the results of ARM code called with IRQ driven audio.
+    */
+    void syncAudio() const { if(myARMIrqAudio) joinARM(); else syncARM(); }
+
+    /**
+      Updates any data fetchers in music mode based on the number of
+      CPU cycles which have passed since the last update.
+    */
+    void updateMusicModeDataFetchers()
+    {
+      syncAudio();
+      myMusicClock.update(mySystem->cycles(), myMusicCounters, myMusicFrequencies);
+    }
+
+    /**
+      Access 32-bit little-endian values in the Harmony RAM, as
+      seen by the ARM.  Any running ARM code is finished first.
+
+      @param address  The offset into the Harmony RAM
+    */
+    uInt32 getRAMWord(uInt16 address) const
+    {
+      syncARM();
+      return readRAMWord(address);
+    }
+    uInt32 getAudioRAMWord(uInt16 address) const
+    {
+      syncAudio();
+      return readRAMWord(address);
+    }
+    void setRAMWord(uInt16 address, uInt32 value)
+    {
+      syncARM();
+      myRAM[address + 0] = value & 0xff;          // low byte
+      myRAM[address + 1] = (value >> 8) & 0xff;
+      myRAM[address + 2] = (value >> 16) & 0xff;
+      myRAM[address + 3] = (value >> 24) & 0xff;  // high byte
+    }
+
+    /**
+      Set the location of the datastream pointers and increments
+      within the RAM copy of the driver.
+
+      @param pointers    Offset of the datastream pointer table
+      @param increments  Offset of the datastream increment table
+      @param count       Number of datastreams to cache (at most MAX_DATASTREAMS);
+                         any streams beyond these are always accessed in RAM
+    */
+    void setDatastreamLocation(uInt16 pointers, uInt16 increments, uInt8 count);
+
+    /**
+      Access the datastream pointers and increments.  While the 6507 is
+      running, these are cached in native form, and only written back to
+      RAM when the ARM code is called, or the state is saved.
+    */
+    uInt32 getDatastreamPointer(uInt8 index) const
+    {
+      return myDatastreamsCached && index < myDatastreamCount
+               ? myDatastreamPointers[index]
+               : getRAMWord(myDatastreamPointerBase + index * 4);
+    }
+    void setDatastreamPointer(uInt8 index, uInt32 value)
+    {
+      if(index < myDatastreamCount && cacheDatastreams())
+        myDatastreamPointers[index] = value;
+      else
+        setRAMWord(myDatastreamPointerBase + index * 4, value);
+    }
+
+    uInt32 getDatastreamIncrement(uInt8 index) const
+    {
+      return myDatastreamsCached && index < myDatastreamCount
+               ? myDatastreamIncrements[index]
+               : getRAMWord(myDatastreamIncrementBase + index * 4);
+    }
+    void setDatastreamIncrement(uInt8 index, uInt32 value)
+    {
+      if(index < myDatastreamCount && cacheDatastreams())
+        myDatastreamIncrements[index] = value;
+      else
+        setRAMWord(myDatastreamIncrementBase + index * 4, value);
+    }
+
+    /**
+      Read the next value from the given datastream, and advance the
+      datastream pointer by its increment.
+
+      @param index  The datastream to read from
+      @return  The value at the current position of the datastream
+    */
+    uInt8 readFromDatastream(uInt8 index)
+    {
+      // Pointers are stored as:
+      // PPPFF---
+      //
+      // Increments are stored as
+      // ----IIFF
+      //
+      // P = Pointer
+      // I = Increment
+      // F = Fractional
+
+      if(index >= myDatastreamCount || !cacheDatastreams())
+        return readFromUncachedDatastream(index);
+
+      uInt32& pointer = myDatastreamPointers[index];
+      uInt8 value = myDisplayImage[ pointer >> 20 ];
+      pointer += uInt16(myDatastreamIncrements[index]) << 12;
+      return value;
+    }
+
+    /**
+      Write the given value to the given datastream, and advance the
+      datastream pointer by one.
+
+      @param index  The datastream to write to
+      @param value  The value to write
+    */
+    void writeToDatastream(uInt8 index, uInt8 value)
+    {
+      uInt32 pointer = getDatastreamPointer(index);
+      myDisplayImage[ pointer >> 20 ] = value;
+      setDatastreamPointer(index, pointer + 0x100000);  // always increment by 1
+    }
+
+    /**
+      Set the high byte of the given datastream pointer, as done by the
+      DSPTR hotspot of the CDF and BUS schemes.
+
+      @param index  The datastream to modify
+      @param value  The new pointer value
+    */
+    void shiftDatastreamPointer(uInt8 index, uInt8 value)
+    {
+      uInt32 pointer = getDatastreamPointer(index);
+      pointer <<= 8;
+      pointer &= 0xf0000000;
+      pointer |= (value << 20);
+      setDatastreamPointer(index, pointer);
+    }
+
+  protected:
+    // The Harmony 8K RAM image, used as:
+    //   driver, display data, C variables & stack
+    // The exact layout depends on the cartridge scheme
+    uInt8 myRAM[8192];
+
+    // Pointer to the display data RAM (the part of the RAM the
+    // datastreams/data fetchers operate on)
+    uInt8* myDisplayImage;
+
+    // Pointer to the Thumb ARM emulator object
+    unique_ptr<Thumbulator> myThumbEmulator;
+
+    // Converts system cycles into OSC clocks for the music data fetchers
+    MusicClock myMusicClock;
+
+    // System cycle count when the last Thumbulator::run() occurred
+    uInt64 myARMCycles;
+
+    // The music counters, ARM FIQ shadow registers r8, r9, r10
+    uInt32 myMusicCounters[3];
+
+    // The music frequency, ARM FIQ shadow registers r11, r12, r13
+    uInt32 myMusicFrequencies[3];
+
+    // The music waveform sizes
+    uInt8 myMusicWaveformSize[3];
+
+  private:
+    uInt32 readRAMWord(uInt16 address) const
+    {
+      return  myRAM[address + 0]        +  // low byte
+             (myRAM[address + 1] << 8)  +
+             (myRAM[address + 2] << 16) +
+             (myRAM[address + 3] << 24) ;  // high byte
+    }
+
+    /**
+      Make sure the datastreams are cached.  In the debugger (bank locked),
+      the RAM is accessed directly instead, since it may be edited there.
+
+      @return  True if the cached datastreams can be used
+    */
+    bool cacheDatastreams()
+    {
+      if(!myDatastreamsCached && !bankLocked())
+        loadDatastreams();
+      return myDatastreamsCached;
+    }
+
+    /**
+      Copy the datastream pointers and increments from RAM into the cache.
+    */
+    void loadDatastreams();
+
+    /**
+      Write the cached datastream pointers and increments (if any) back
+      into the given RAM image.
+
+      @param ram  The Harmony RAM image to update
+    */
+    void flushDatastreams(uInt8* ram) const;
+
+    /**
+      Slow path of readFromDatastream(), working directly on RAM.
+    */
+    uInt8 readFromUncachedDatastream(uInt8 index);
+
+    /**
+      Execute the ARM code, remembering any fatal error.
+    */
+    void executeARM(Int32 cycles);
+
+    /**
+      Hand the ARM call over to the worker thread, starting it if necessary.
+    */
+    void startARM(Int32 cycles);
+
+    /**
+      Main loop of the worker thread: sleep until an ARM call is handed
+      over, and execute it.
+    */
+    void armThreadMain();
+
+    /**
+      Check whether the last ARM call would still be running on real
+      hardware, and report it.
+
+      @param elapsed  The 6507 cycles which passed between the last ARM
+                      call and the first access to its results
+    */
+    void checkARMOverrun(uInt32 elapsed) const;
+
+    /**
+      Complete the last ARM call, see syncARM().
+    */
+    void finishARM() const;
+
+    /**
+      Wait for the ARM thread (if any) to finish, and report its errors.
+      Unlike syncARM(), this doesn't count as an access to the results
+      (used when saving/loading state, or in the debugger).
+    */
+    void joinARM() const;
+
+    /**
+      Report (and clear) a fatal error from the last ARM call.
+    */
+    void reportARMError() const;
+
+  private:
+    // Run the ARM code in a separate thread
+    bool myThreadedARM;
+
+    // Enter the debugger on ARM cycle overruns (otherwise only log them)
+    bool myTrapOverrun;
+
+    // Estimated duration of the last ARM call, in 6507 cycles
+    uInt32 myARMDuration;
+
+    // Largest overrun logged so far, in 6507 cycles
+    mutable uInt32 myWorstOverrun;
+
+    // The results of the last ARM call haven't been accessed yet
+    mutable bool myARMPending;
+
+    // The last ARM call serves the audio by IRQ while running
+    bool myARMIrqAudio;
+
+    // The worker thread running the ARM code (only in threaded mode)
+    std::thread myARMThread;
+
+    // Wakes the worker for a new call, and the 6507 when the call is done
+    mutable std::mutex myARMMutex;
+    mutable std::condition_variable myARMCondition;
+
+    // An ARM call has been handed to the worker and isn't finished yet
+    std::atomic<bool> myARMBusy;
+
+    // The worker is to exit
+    bool myARMQuit;
+
+    // The 6507 cycles passed to the ARM call handed to the worker
+    Int32 myARMRunCycles;
+
+    // Error message of a fatal error in the last ARM call, if any
+    mutable string myARMError;
+
+    // Location and number of the datastream pointers and increments in RAM
+    uInt16 myDatastreamPointerBase;
+    uInt16 myDatastreamIncrementBase;
+    uInt8 myDatastreamCount;
+
+    // Native copies of the datastream pointers and increments; when valid,
+    // these take precedence over the values in RAM
+    static constexpr uInt8 MAX_DATASTREAMS = 34;
+    uInt32 myDatastreamPointers[MAX_DATASTREAMS];
+    uInt32 myDatastreamIncrements[MAX_DATASTREAMS];
+    bool myDatastreamsCached;
+
+  private:
+    // Following constructors and assignment operators not supported
+    CartridgeARM() = delete;
+    CartridgeARM(const CartridgeARM&) = delete;
+    CartridgeARM(CartridgeARM&&) = delete;
+    CartridgeARM& operator=(const CartridgeARM&) = delete;
+    CartridgeARM& operator=(CartridgeARM&&) = delete;
+};
+
+#endif
@@ -17,9 +17,6 @@
 
 #include <cstring>
 
-#ifdef DEBUGGER_SUPPORT
-  #include "Debugger.hxx"
-#endif
 #include "System.hxx"
 #include "M6532.hxx"
 #include "TIA.hxx"
@@ -42,10 +39,7 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeBUS::CartridgeBUS(const BytePtr& image, uInt32 size,
                            const Settings& settings)
-  : Cartridge(settings),
-    myAudioCycles(0),
-    myARMCycles(0),
-    myFractionalClocks(0.0)
+  : CartridgeARM(settings)
 {
   // Copy the ROM image into my buffer
   memcpy(myImage, image.get(), std::min(32768u, size));
@@ -58,17 +52,17 @@ CartridgeBUS::CartridgeBUS(const BytePtr& image, uInt32 size,
   myProgramImage = myImage + 4096;
 
   // Pointer to BUS driver in RAM
-  myBusDriverImage = myBUSRAM;
+  myBusDriverImage = myRAM;
 
   // Pointer to the display RAM
-  myDisplayImage = myBUSRAM + DSRAM;
+  myDisplayImage = myRAM + DSRAM;
+  // Only the 16 regular datastreams are cached: the increments of the
+  // COMMSTREAM and JUMPSTREAM overlap DSMAPS, which busOverdrive() updates
+  // in RAM
+  setDatastreamLocation(DSxPTR, DSxINC, COMMSTREAM);
 
   // Create Thumbulator ARM emulator
-  const string& prefix = settings.getBool("dev.settings") ? "dev." : "plr.";
-  myThumbEmulator = make_unique<Thumbulator>(
-    reinterpret_cast<uInt16*>(myImage), reinterpret_cast<uInt16*>(myBUSRAM),
-    settings.getBool(prefix + "thumb.trapfatal"), Thumbulator::ConfigureFor::BUS, this
-  );
+  createThumbulator(myImage, Thumbulator::ConfigureFor::BUS);
 
   setInitialState();
 }
@@ -76,11 +70,10 @@ CartridgeBUS::CartridgeBUS(const BytePtr& image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::reset()
 {
-  initializeRAM(myBUSRAM+2048, 8192-2048);
-
   // Update cycles to the current system cycles
-  myAudioCycles = myARMCycles = 0;
-  myFractionalClocks = 0.0;
+  resetARM();
+
+  initializeRAM(myRAM+2048, 8192-2048);
 
   setInitialState();
 
@@ -110,12 +103,6 @@ void CartridgeBUS::setInitialState()
   myFastJumpActive = 0;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void CartridgeBUS::consoleChanged(ConsoleTiming timing)
-{
-  myThumbEmulator->setConsoleTiming(timing);
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::install(System& system)
 {
@@ -135,49 +122,18 @@ void CartridgeBUS::install(System& system)
   bank(startBank());
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline void CartridgeBUS::updateMusicModeDataFetchers()
-{
-  // Calculate the number of cycles since the last update
-  uInt32 cycles = uInt32(mySystem->cycles() - myAudioCycles);
-  myAudioCycles = mySystem->cycles();
-
-  // Calculate the number of BUS OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
-
-  // Let's update counters and flags of the music mode data fetchers
-  if(wholeClocks > 0)
-    for(int x = 0; x <= 2; ++x)
-      myMusicCounters[x] += myMusicFrequencies[x] * wholeClocks;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void CartridgeBUS::callFunction(uInt8 value)
 {
   switch (value)
   {
     // Call user written ARM code (will most likely be C compiled for ARM)
-    case 254: // call with IRQ driven audio, no special handling needed at this
-              // time for Stella as ARM code "runs in zero 6507 cycles".
+    case 254: // call with IRQ driven audio
+      runARM(true);
+      break;
+
     case 255: // call without IRQ driven audio
-      try {
-        Int32 cycles = Int32(mySystem->cycles() - myARMCycles);
-        myARMCycles = mySystem->cycles();
-
-        myThumbEmulator->run(cycles);
-      }
-      catch(const runtime_error& e) {
-        if(!mySystem->autodetectMode())
-        {
-      #ifdef DEBUGGER_SUPPORT
-          Debugger::debugger().startWithFatalError(e.what());
-      #else
-          cout << e.what() << endl;
-      #endif
-        }
-      }
+      runARM(false);
       break;
   }
 }
@@ -209,16 +165,13 @@ uInt8 CartridgeBUS::peek(uInt16 address)
     if (myFastJumpActive
         && myJMPoperandAddress == address)
     {
-      uInt32 pointer;
-      uInt8 value;
-
       --myFastJumpActive;
       ++myJMPoperandAddress;
 
-      pointer = getDatastreamPointer(JUMPSTREAM);
-      value = myDisplayImage[ pointer >> 20 ];
-      pointer += 0x100000;  // always increment by 1
-      setDatastreamPointer(JUMPSTREAM, pointer);
+      // always increment by 1
+      uInt32 pointer = getDatastreamPointer(JUMPSTREAM);
+      uInt8 value = myDisplayImage[ pointer >> 20 ];
+      setDatastreamPointer(JUMPSTREAM, pointer + 0x100000);
 
       return value;
     }
@@ -257,7 +210,7 @@ uInt8 CartridgeBUS::peek(uInt16 address)
           if (sampleaddress < 0x8000)
             peekvalue = myImage[sampleaddress];
           else if (sampleaddress >= 0x40000000 && sampleaddress < 0x40002000) // check for RAM
-            peekvalue = myBUSRAM[sampleaddress - 0x40000000];
+            peekvalue = myRAM[sampleaddress - 0x40000000];
           else
             peekvalue = 0;
 
@@ -354,8 +307,6 @@ bool CartridgeBUS::poke(uInt16 address, uInt8 value)
   }
   else
   {
-    uInt32 pointer;
-
     address &= 0x0FFF;
 
     switch(address)
@@ -366,18 +317,11 @@ bool CartridgeBUS::poke(uInt16 address, uInt8 value)
         break;
 
       case 0xFF0: // DSWRITE
-        pointer = getDatastreamPointer(COMMSTREAM);
-        myDisplayImage[ pointer >> 20 ] = value;
-        pointer += 0x100000;  // always increment by 1 when writing
-        setDatastreamPointer(COMMSTREAM, pointer);
+        writeToDatastream(COMMSTREAM, value);
         break;
 
       case 0xFF1: // DSPTR
-        pointer = getDatastreamPointer(COMMSTREAM);
-        pointer <<=8;
-        pointer &= 0xf0000000;
-        pointer |= (value << 20);
-        setDatastreamPointer(COMMSTREAM, pointer);
+        shiftDatastreamPointer(COMMSTREAM, value);
         break;
 
       case 0xFF2: // SETMODE
@@ -512,61 +456,22 @@ uInt8 CartridgeBUS::busOverdrive(uInt16 address)
   return overdrive;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 CartridgeBUS::thumbCallback(uInt8 function, uInt32 value1, uInt32 value2)
-{
-  switch (function)
-  {
-    case 0:
-      // _SetNote - set the note/frequency
-      myMusicFrequencies[value1] = value2;
-      break;
-
-      // _ResetWave - reset counter,
-      // used to make sure digital samples start from the beginning
-    case 1:
-      myMusicCounters[value1] = 0;
-      break;
-
-      // _GetWavePtr - return the counter
-    case 2:
-      return myMusicCounters[value1];
-
-      // _SetWaveSize - set size of waveform buffer
-    case 3:
-      myMusicWaveformSize[value1] = value2;
-      break;
-  }
-
-  return 0;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeBUS::save(Serializer& out) const
 {
+  if(!CartridgeARM::save(out))
+    return false;
+
   try
   {
     // Indicates which bank is currently active
     out.putShort(myBankOffset);
 
-    // Harmony RAM
-    out.putByteArray(myBUSRAM, 8192);
-
     // Addresses for bus override logic
     out.putShort(myBusOverdriveAddress);
     out.putShort(mySTYZeroPageAddress);
     out.putShort(myJMPoperandAddress);
 
-    // Save cycles and clocks
-    out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
-    out.putLong(myARMCycles);
-
-    // Audio info
-    out.putIntArray(myMusicCounters, 3);
-    out.putIntArray(myMusicFrequencies, 3);
-    out.putByteArray(myMusicWaveformSize, 3);
-
     // Indicates current mode
     out.putByte(myMode);
 
@@ -585,29 +490,19 @@ bool CartridgeBUS::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeBUS::load(Serializer& in)
 {
+  if(!CartridgeARM::load(in))
+    return false;
+
   try
   {
     // Indicates which bank is currently active
     myBankOffset = in.getShort();
 
-    // Harmony RAM
-    in.getByteArray(myBUSRAM, 8192);
-
     // Addresses for bus override logic
     myBusOverdriveAddress = in.getShort();
     mySTYZeroPageAddress = in.getShort();
     myJMPoperandAddress = in.getShort();
 
-    // Get system cycles and fractional clocks
-    myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
-    myARMCycles = in.getLong();
-
-    // Audio info
-    in.getIntArray(myMusicCounters, 3);
-    in.getIntArray(myMusicFrequencies, 3);
-    in.getByteArray(myMusicWaveformSize, 3);
-
     // Indicates current mode
     myMode = in.getByte();
 
@@ -626,45 +521,11 @@ bool CartridgeBUS::load(Serializer& in)
   return true;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 CartridgeBUS::getDatastreamPointer(uInt8 index) const
-{
-//  index &= 0x0f;
-
-  return myBUSRAM[DSxPTR + index*4 + 0]        +  // low byte
-        (myBUSRAM[DSxPTR + index*4 + 1] << 8)  +
-        (myBUSRAM[DSxPTR + index*4 + 2] << 16) +
-        (myBUSRAM[DSxPTR + index*4 + 3] << 24) ;  // high byte
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void CartridgeBUS::setDatastreamPointer(uInt8 index, uInt32 value)
-{
-//  index &= 0x0f;
-  myBUSRAM[DSxPTR + index*4 + 0] = value & 0xff;          // low byte
-  myBUSRAM[DSxPTR + index*4 + 1] = (value >> 8) & 0xff;
-  myBUSRAM[DSxPTR + index*4 + 2] = (value >> 16) & 0xff;
-  myBUSRAM[DSxPTR + index*4 + 3] = (value >> 24) & 0xff;  // high byte
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 CartridgeBUS::getDatastreamIncrement(uInt8 index) const
-{
-//  index &= 0x0f;
-  return myBUSRAM[DSxINC + index*4 + 0]        +   // low byte
-        (myBUSRAM[DSxINC + index*4 + 1] << 8)  +
-        (myBUSRAM[DSxINC + index*4 + 2] << 16) +
-        (myBUSRAM[DSxINC + index*4 + 3] << 24) ;   // high byte
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getAddressMap(uInt8 index) const
 {
   //  index &= 0x0f;
-  return myBUSRAM[DSMAPS + index*4 + 0]        +   // low byte
-        (myBUSRAM[DSMAPS + index*4 + 1] << 8)  +
-        (myBUSRAM[DSMAPS + index*4 + 2] << 16) +
-        (myBUSRAM[DSMAPS + index*4 + 3] << 24) ;   // high byte
+  return getRAMWord(DSMAPS + index*4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -676,20 +537,7 @@ uInt32 CartridgeBUS::getWaveform(uInt8 index) const
   // 0x40000840 for 2
   // ...
 
-//  return myBUSRAM[WAVEFORM + index*4 + 0]        +   // low byte
-//        (myBUSRAM[WAVEFORM + index*4 + 1] << 8)  +
-//        (myBUSRAM[WAVEFORM + index*4 + 2] << 16) +
-//        (myBUSRAM[WAVEFORM + index*4 + 3] << 24) -   // high byte
-//         0x40000800;
-
-  uInt32 result;
-
-  result = myBUSRAM[WAVEFORM + index*4 + 0]        +  // low byte
-          (myBUSRAM[WAVEFORM + index*4 + 1] << 8)  +
-          (myBUSRAM[WAVEFORM + index*4 + 2] << 16) +
-          (myBUSRAM[WAVEFORM + index*4 + 3] << 24);   // high byte
-
-  result -= 0x40000800;
+  uInt32 result = getAudioRAMWord(WAVEFORM + index*4) - 0x40000800;
 
   if (result >= 4096)
     result = 0;
@@ -700,14 +548,7 @@ uInt32 CartridgeBUS::getWaveform(uInt8 index) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getSample()
 {
-  uInt32 result;
-
-  result = myBUSRAM[WAVEFORM + 0]        +  // low byte
-          (myBUSRAM[WAVEFORM + 1] << 8)  +
-          (myBUSRAM[WAVEFORM + 2] << 16) +
-          (myBUSRAM[WAVEFORM + 3] << 24);   // high byte
-
-  return result;
+  return getAudioRAMWord(WAVEFORM);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -720,29 +561,6 @@ uInt32 CartridgeBUS::getWaveformSize(uInt8 index) const
 void CartridgeBUS::setAddressMap(uInt8 index, uInt32 value)
 {
   //  index &= 0x0f;
-  myBUSRAM[DSMAPS + index*4 + 0] = value & 0xff;          // low byte
-  myBUSRAM[DSMAPS + index*4 + 1] = (value >> 8) & 0xff;
-  myBUSRAM[DSMAPS + index*4 + 2] = (value >> 16) & 0xff;
-  myBUSRAM[DSMAPS + index*4 + 3] = (value >> 24) & 0xff;  // high byte
+  setRAMWord(DSMAPS + index*4, value);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 CartridgeBUS::readFromDatastream(uInt8 index)
-{
-  // Pointers are stored as:
-  // PPPFF---
-  //
-  // Increments are stored as
-  // ----IIFF
-  //
-  // P = Pointer
-  // I = Increment
-  // F = Fractional
-
-  uInt32 pointer = getDatastreamPointer(index);
-  uInt16 increment = getDatastreamIncrement(index);
-  uInt8 value = myDisplayImage[ pointer >> 20 ];
-  pointer += (increment << 12);
-  setDatastreamPointer(index, pointer);
-  return value;
-}
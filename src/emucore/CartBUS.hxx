@@ -18,14 +18,12 @@
 #ifndef CARTRIDGE_BUS_HXX
 #define CARTRIDGE_BUS_HXX
 
-class System;
-class Thumbulator;
 #ifdef DEBUGGER_SUPPORT
   #include "CartBUSWidget.hxx"
 #endif
 
 #include "bspf.hxx"
-#include "Cart.hxx"
+#include "CartARM.hxx"
 
 /**
   Cartridge class used for BUS.
@@ -40,7 +38,7 @@ class Thumbulator;
   @authors: Darrell Spice Jr, Chris Walton, Fred Quimby,
             Stephen Anthony, Bradford W. Mott
 */
-class CartridgeBUS : public Cartridge
+class CartridgeBUS : public CartridgeARM
 {
   friend class CartridgeBUSWidget;
   friend class CartridgeRamBUSWidget;
@@ -62,15 +60,6 @@ class CartridgeBUS : public Cartridge
     */
     void reset() override;
 
-    /**
-      Notification method invoked by the system when the console type
-      has changed.  We need this to inform the Thumbulator that the
-      timing has changed.
-
-      @param timing  Enum representing the new console type
-    */
-    void consoleChanged(ConsoleTiming timing) override;
-
     /**
       Install cartridge in the specified system.  Invoked by the system
       when the cartridge is attached to it.
@@ -138,11 +127,6 @@ class CartridgeBUS : public Cartridge
 
     uInt8 busOverdrive(uInt16 address);
 
-  /**
-   Used for Thumbulator to pass values back to the cartridge
-   */
-  uInt32 thumbCallback(uInt8 function, uInt32 value1, uInt32 value2) override;
-
 
   #ifdef DEBUGGER_SUPPORT
     /**
@@ -179,28 +163,14 @@ class CartridgeBUS : public Cartridge
     */
     void setInitialState();
 
-    /**
-      Updates any data fetchers in music mode based on the number of
-      CPU cycles which have passed since the last update.
-    */
-    void updateMusicModeDataFetchers();
-
     /**
       Call Special Functions
     */
     void callFunction(uInt8 value);
 
-    uInt32 getDatastreamPointer(uInt8 index) const;
-    void setDatastreamPointer(uInt8 index, uInt32 value);
-
-    uInt32 getDatastreamIncrement(uInt8 index) const;
-    void setDatastreamIncrement(uInt8 index, uInt32 value);
-
     uInt32 getAddressMap(uInt8 index) const;
     void setAddressMap(uInt8 index, uInt32 value);
 
-    uInt8 readFromDatastream(uInt8 index);
-
     uInt32 getWaveform(uInt8 index) const;
     uInt32 getWaveformSize(uInt8 index) const;
     uInt32 getSample();
@@ -212,20 +182,12 @@ class CartridgeBUS : public Cartridge
     // Pointer to the 28K program ROM image of the cartridge
     uInt8* myProgramImage;
 
-    // Pointer to the 4K display ROM image of the cartridge
-    uInt8* myDisplayImage;
-
     // Pointer to the 2K BUS driver image in RAM
-    uInt8* myBusDriverImage;
-
-    // The BUS 8k RAM image, used as:
+    // The BUS 8k RAM image is used as:
     //   $0000 - 2K BUS driver
     //   $0800 - 4K Display Data
     //   $1800 - 2K C Variable & Stack
-    uInt8 myBUSRAM[8192];
-
-    // Pointer to the Thumb ARM emulator object
-    unique_ptr<Thumbulator> myThumbEmulator;
+    uInt8* myBusDriverImage;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
@@ -240,24 +202,6 @@ class CartridgeBUS : public Cartridge
     // *and* the next two bytes in ROM are 00 00
     uInt16 myJMPoperandAddress;
 
-    // System cycle count from when the last update to music data fetchers occurred
-    uInt64 myAudioCycles;
-
-    // ARM cycle count from when the last callFunction() occurred
-    uInt64 myARMCycles;
-
-    // The music mode counters
-    uInt32 myMusicCounters[3];
-
-    // The music frequency
-    uInt32 myMusicFrequencies[3];
-
-    // The music waveform sizes
-    uInt8 myMusicWaveformSize[3];
-
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
-
     // Controls mode, lower nybble sets Fast Fetch, upper nybble sets audio
     // -0 = Bus Stuffing ON
     // -F = Bus Stuffing OFF
@@ -17,10 +17,6 @@
 
 #include <cstring>
 
-#ifdef DEBUGGER_SUPPORT
-  #include "Debugger.hxx"
-#endif
-
 #include "System.hxx"
 #include "Thumbulator.hxx"
 #include "CartCDF.hxx"
@@ -43,10 +39,7 @@ const uInt16 WAVEFORM[] = {0x07F0, 0x01B0};
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeCDF::CartridgeCDF(const BytePtr& image, uInt32 size,
                            const Settings& settings)
-  : Cartridge(settings),
-    myAudioCycles(0),
-    myARMCycles(0),
-    myFractionalClocks(0.0)
+  : CartridgeARM(settings)
 {
   // Copy the ROM image into my buffer
   memcpy(myImage, image.get(), std::min(32768u, size));
@@ -59,19 +52,17 @@ CartridgeCDF::CartridgeCDF(const BytePtr& image, uInt32 size,
   myProgramImage = myImage + 4096;
 
   // Pointer to CDF driver in RAM
-  myBusDriverImage = myCDFRAM;
+  myBusDriverImage = myRAM;
 
   // Pointer to the display RAM
-  myDisplayImage = myCDFRAM + DSRAM;
+  myDisplayImage = myRAM + DSRAM;
 
   setVersion();
+  setDatastreamLocation(DSxPTR[myVersion], DSxINC[myVersion], JUMPSTREAM + 1);
 
   // Create Thumbulator ARM emulator
-  const string& prefix = settings.getBool("dev.settings") ? "dev." : "plr.";
-  myThumbEmulator = make_unique<Thumbulator>(
-    reinterpret_cast<uInt16*>(myImage), reinterpret_cast<uInt16*>(myCDFRAM),
-    settings.getBool(prefix + "thumb.trapfatal"), myVersion ?
-    Thumbulator::ConfigureFor::CDF1 : Thumbulator::ConfigureFor::CDF, this);
+  createThumbulator(myImage, myVersion ?
+    Thumbulator::ConfigureFor::CDF1 : Thumbulator::ConfigureFor::CDF);
 
   setInitialState();
 }
@@ -79,10 +70,9 @@ CartridgeCDF::CartridgeCDF(const BytePtr& image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::reset()
 {
-  initializeRAM(myCDFRAM+2048, 8192-2048);
+  resetARM();
 
-  myAudioCycles = myARMCycles = 0;
-  myFractionalClocks = 0.0;
+  initializeRAM(myRAM+2048, 8192-2048);
 
   setInitialState();
 
@@ -110,12 +100,6 @@ void CartridgeCDF::setInitialState()
   myFastJumpActive = 0;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void CartridgeCDF::consoleChanged(ConsoleTiming timing)
-{
-  myThumbEmulator->setConsoleTiming(timing);
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::install(System& system)
 {
@@ -130,49 +114,18 @@ void CartridgeCDF::install(System& system)
   bank(startBank());
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline void CartridgeCDF::updateMusicModeDataFetchers()
-{
-  // Calculate the number of cycles since the last update
-  uInt32 cycles = uInt32(mySystem->cycles() - myAudioCycles);
-  myAudioCycles = mySystem->cycles();
-
-  // Calculate the number of CDF OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
-
-  // Let's update counters and flags of the music mode data fetchers
-  if(wholeClocks > 0)
-    for(int x = 0; x <= 2; ++x)
-      myMusicCounters[x] += myMusicFrequencies[x] * wholeClocks;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void CartridgeCDF::callFunction(uInt8 value)
 {
   switch (value)
   {
     // Call user written ARM code (will most likely be C compiled for ARM)
-    case 254: // call with IRQ driven audio, no special handling needed at this
-              // time for Stella as ARM code "runs in zero 6507 cycles".
-    case 255: // call without IRQ driven audio
-      try {
-        Int32 cycles = Int32(mySystem->cycles() - myARMCycles);
-        myARMCycles = mySystem->cycles();
+    case 254: // call with IRQ driven audio
+      runARM(true);
+      break;
 
-        myThumbEmulator->run(cycles);
-      }
-      catch(const runtime_error& e) {
-        if(!mySystem->autodetectMode())
-        {
-#ifdef DEBUGGER_SUPPORT
-          Debugger::debugger().startWithFatalError(e.what());
-#else
-          cout << e.what() << endl;
-#endif
-        }
-      }
+    case 255: // call without IRQ driven audio
+      runARM(false);
       break;
   }
 }
@@ -193,16 +146,13 @@ uInt8 CartridgeCDF::peek(uInt16 address)
   if (myFastJumpActive
       && myJMPoperandAddress == address)
   {
-    uInt32 pointer;
-    uInt8 value;
-
     --myFastJumpActive;
     ++myJMPoperandAddress;
 
-    pointer = getDatastreamPointer(JUMPSTREAM);
-    value = myDisplayImage[ pointer >> 20 ];
-    pointer += 0x100000;  // always increment by 1
-    setDatastreamPointer(JUMPSTREAM, pointer);
+    // always increment by 1
+    uInt32 pointer = getDatastreamPointer(JUMPSTREAM);
+    uInt8 value = myDisplayImage[ pointer >> 20 ];
+    setDatastreamPointer(JUMPSTREAM, pointer + 0x100000);
 
     return value;
   }
@@ -242,7 +192,7 @@ uInt8 CartridgeCDF::peek(uInt16 address)
         if (sampleaddress < 0x8000)
           peekvalue = myImage[sampleaddress];
         else if (sampleaddress >= 0x40000000 && sampleaddress < 0x40002000) // check for RAM
-          peekvalue = myCDFRAM[sampleaddress - 0x40000000];
+          peekvalue = myRAM[sampleaddress - 0x40000000];
         else
           peekvalue = 0;
 
@@ -317,25 +267,16 @@ uInt8 CartridgeCDF::peek(uInt16 address)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCDF::poke(uInt16 address, uInt8 value)
 {
-  uInt32 pointer;
-
   address &= 0x0FFF;
 
   switch(address)
   {
     case 0xFF0:   // DSWRITE
-      pointer = getDatastreamPointer(COMMSTREAM);
-      myDisplayImage[ pointer >> 20 ] = value;
-      pointer += 0x100000;  // always increment by 1 when writing
-      setDatastreamPointer(COMMSTREAM, pointer);
+      writeToDatastream(COMMSTREAM, value);
       break;
 
     case 0xFF1:   // DSPTR
-      pointer = getDatastreamPointer(COMMSTREAM);
-      pointer <<=8;
-      pointer &= 0xf0000000;
-      pointer |= (value << 20);
-      setDatastreamPointer(COMMSTREAM, pointer);
+      shiftDatastreamPointer(COMMSTREAM, value);
       break;
 
     case 0xFF2:   // SETMODE
@@ -442,40 +383,12 @@ const uInt8* CartridgeCDF::getImage(uInt32& size) const
   return myImage;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-uInt32 CartridgeCDF::thumbCallback(uInt8 function, uInt32 value1, uInt32 value2)
-{
-  switch (function)
-  {
-    case 0:
-      // _SetNote - set the note/frequency
-      myMusicFrequencies[value1] = value2;
-      break;
-
-      // _ResetWave - reset counter,
-      // used to make sure digital samples start from the beginning
-    case 1:
-      myMusicCounters[value1] = 0;
-      break;
-
-      // _GetWavePtr - return the counter
-    case 2:
-      return myMusicCounters[value1];
-
-      // _SetWaveSize - set size of waveform buffer
-    case 3:
-      myMusicWaveformSize[value1] = value2;
-      break;
-  }
-
-  return 0;
-}
-
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCDF::save(Serializer& out) const
 {
+  if(!CartridgeARM::save(out))
+    return false;
+
   try
   {
     // Indicates which bank is currently active
@@ -490,19 +403,6 @@ bool CartridgeCDF::save(Serializer& out) const
     // operand addresses
     out.putShort(myLDAimmediateOperandAddress);
     out.putShort(myJMPoperandAddress);
-
-    // Harmony RAM
-    out.putByteArray(myCDFRAM, 8192);
-
-    // Audio info
-    out.putIntArray(myMusicCounters, 3);
-    out.putIntArray(myMusicFrequencies, 3);
-    out.putByteArray(myMusicWaveformSize, 3);
-
-    // Save cycles and clocks
-    out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
-    out.putLong(myARMCycles);
   }
   catch(...)
   {
@@ -516,6 +416,9 @@ bool CartridgeCDF::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCDF::load(Serializer& in)
 {
+  if(!CartridgeARM::load(in))
+    return false;
+
   try
   {
     // Indicates which bank is currently active
@@ -530,19 +433,6 @@ bool CartridgeCDF::load(Serializer& in)
     // Address of LDA # operand
     myLDAimmediateOperandAddress = in.getShort();
     myJMPoperandAddress = in.getShort();
-
-    // Harmony RAM
-    in.getByteArray(myCDFRAM, 8192);
-
-    // Audio info
-    in.getIntArray(myMusicCounters, 3);
-    in.getIntArray(myMusicFrequencies, 3);
-    in.getByteArray(myMusicWaveformSize, 3);
-
-    // Get cycles and clocks
-    myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
-    myARMCycles = in.getLong();
   }
   catch(...)
   {
@@ -556,49 +446,10 @@ bool CartridgeCDF::load(Serializer& in)
   return true;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 CartridgeCDF::getDatastreamPointer(uInt8 index) const
-{
-  uInt16 address = DSxPTR[myVersion] + index * 4;
-
-  return myCDFRAM[address + 0]        +  // low byte
-        (myCDFRAM[address + 1] << 8)  +
-        (myCDFRAM[address + 2] << 16) +
-        (myCDFRAM[address + 3] << 24) ;  // high byte
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void CartridgeCDF::setDatastreamPointer(uInt8 index, uInt32 value)
-{
-  uInt16 address = DSxPTR[myVersion] + index * 4;
-
-  myCDFRAM[address + 0] = value & 0xff;          // low byte
-  myCDFRAM[address + 1] = (value >> 8) & 0xff;
-  myCDFRAM[address + 2] = (value >> 16) & 0xff;
-  myCDFRAM[address + 3] = (value >> 24) & 0xff;  // high byte
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 CartridgeCDF::getDatastreamIncrement(uInt8 index) const
-{
-  uInt16 address = DSxINC[myVersion] + index * 4;
-
-  return myCDFRAM[address + 0]        +   // low byte
-        (myCDFRAM[address + 1] << 8)  +
-        (myCDFRAM[address + 2] << 16) +
-        (myCDFRAM[address + 3] << 24) ;   // high byte
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getWaveform(uInt8 index) const
 {
-  uInt32 result;
-  uInt16 address = WAVEFORM[myVersion] + index * 4;
-
-  result = myCDFRAM[address + 0]        +  // low byte
-          (myCDFRAM[address + 1] << 8)  +
-          (myCDFRAM[address + 2] << 16) +
-          (myCDFRAM[address + 3] << 24);   // high byte
+  uInt32 result = getAudioRAMWord(WAVEFORM[myVersion] + index * 4);
 
   result -= (0x40000000 + DSRAM);
 
@@ -611,15 +462,7 @@ uInt32 CartridgeCDF::getWaveform(uInt8 index) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getSample()
 {
-  uInt32 result;
-  uInt16 address = WAVEFORM[myVersion];
-
-  result = myCDFRAM[address + 0]        +  // low byte
-          (myCDFRAM[address + 1] << 8)  +
-          (myCDFRAM[address + 2] << 16) +
-          (myCDFRAM[address + 3] << 24);   // high byte
-
-  return result;
+  return getAudioRAMWord(WAVEFORM[myVersion]);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -628,27 +471,6 @@ uInt32 CartridgeCDF::getWaveformSize(uInt8 index) const
   return myMusicWaveformSize[index];
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 CartridgeCDF::readFromDatastream(uInt8 index)
-{
-  // Pointers are stored as:
-  // PPPFF---
-  //
-  // Increments are stored as
-  // ----IIFF
-  //
-  // P = Pointer
-  // I = Increment
-  // F = Fractional
-
-  uInt32 pointer = getDatastreamPointer(index);
-  uInt16 increment = getDatastreamIncrement(index);
-  uInt8 value = myDisplayImage[ pointer >> 20 ];
-  pointer += (increment << 12);
-  setDatastreamPointer(index, pointer);
-  return value;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::setVersion()
 {
@@ -18,14 +18,12 @@
 #ifndef CARTRIDGE_CDF_HXX
 #define CARTRIDGE_CDF_HXX
 
-class System;
-class Thumbulator;
 #ifdef DEBUGGER_SUPPORT
   #include "CartCDFWidget.hxx"
 #endif
 
 #include "bspf.hxx"
-#include "Cart.hxx"
+#include "CartARM.hxx"
 
 /**
   Cartridge class used for CDF.
@@ -40,7 +38,7 @@ class Thumbulator;
   @authors: Darrell Spice Jr, Chris Walton, Fred Quimby,
             Stephen Anthony, Bradford W. Mott
 */
-class CartridgeCDF : public Cartridge
+class CartridgeCDF : public CartridgeARM
 {
   friend class CartridgeCDFWidget;
   friend class CartridgeRamCDFWidget;
@@ -62,15 +60,6 @@ class CartridgeCDF : public Cartridge
     */
     void reset() override;
 
-    /**
-      Notification method invoked by the system when the console type
-      has changed.  We need this to inform the Thumbulator that the
-      timing has changed.
-
-      @param timing  Enum representing the new console type
-    */
-    void consoleChanged(ConsoleTiming timing) override;
-
     /**
       Install cartridge in the specified system.  Invoked by the system
       when the cartridge is attached to it.
@@ -136,11 +125,6 @@ class CartridgeCDF : public Cartridge
     */
     string name() const override { return "CartridgeCDF"; }
 
-    /**
-      Used for Thumbulator to pass values back to the cartridge
-    */
-    uInt32 thumbCallback(uInt8 function, uInt32 value1, uInt32 value2) override;
-
 #ifdef DEBUGGER_SUPPORT
     /**
       Get debugger widget responsible for accessing the inner workings
@@ -176,25 +160,11 @@ class CartridgeCDF : public Cartridge
     */
     void setInitialState();
 
-    /**
-      Updates any data fetchers in music mode based on the number of
-      CPU cycles which have passed since the last update.
-    */
-    void updateMusicModeDataFetchers();
-
     /**
       Call Special Functions
     */
     void callFunction(uInt8 value);
 
-    uInt32 getDatastreamPointer(uInt8 index) const;
-    void setDatastreamPointer(uInt8 index, uInt32 value);
-
-    uInt32 getDatastreamIncrement(uInt8 index) const;
-    void setDatastreamIncrement(uInt8 index, uInt32 value);
-
-    uInt8 readFromDatastream(uInt8 index);
-
     uInt32 getWaveform(uInt8 index) const;
     uInt32 getWaveformSize(uInt8 index) const;
     uInt32 getSample();
@@ -207,58 +177,16 @@ class CartridgeCDF : public Cartridge
     // Pointer to the 28K program ROM image of the cartridge
     uInt8* myProgramImage;
 
-    // Pointer to the 4K display ROM image of the cartridge
-    uInt8* myDisplayImage;
-
     // Pointer to the 2K CDF driver image in RAM
-    uInt8* myBusDriverImage;
-
-    // The CDF 8k RAM image, used as:
+    // The CDF 8k RAM image is used as:
     //   $0000 - 2K CDF driver
     //   $0800 - 4K Display Data
     //   $1800 - 2K C Variable & Stack
-    uInt8 myCDFRAM[8192];
-
-    // Pointer to the Thumb ARM emulator object
-    unique_ptr<Thumbulator> myThumbEmulator;
+    uInt8* myBusDriverImage;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
 
-    // System cycle count from when the last update to music data fetchers occurred
-    uInt64 myAudioCycles;
-
-    // ARM cycle count from when the last callFunction() occurred
-    uInt64 myARMCycles;
-
-    // The audio routines in the driver run in 32-bit mode and take advantage
-    // of the FIQ Shadow Registers which are not accessible to 16-bit thumb
-    // code.  As such, Thumbulator does not support them.  The driver supplies a
-    // few 16-bit subroutines used to pass values from 16-bit to 32-bit.  The
-    // Thumbulator will trap these calls and pass the appropriate information to
-    // the Cartridge Class via callFunction() so it can emulate the 32 bit audio routines.
-
-    /* Register usage for audio:
-      r8  = channel0 accumulator
-      r9  = channel1 accumulator
-      r10 = channel2 accumulator
-      r11 = channel0 frequency
-      r12 = channel1 frequency
-      r13 = channel2 frequency
-      r14 = timer base  */
-
-    // The music counters, ARM FIQ shadow registers r8, r9, r10
-    uInt32 myMusicCounters[3];
-
-    // The music frequency, ARM FIQ shadow registers r11, r12, r13
-    uInt32 myMusicFrequencies[3];
-
-    // The music waveform sizes
-    uInt8 myMusicWaveformSize[3];
-
-    // Fractional CDF music, OSC clocks unused during the last update
-    double myFractionalClocks;
-
     // Controls mode, lower nybble sets Fast Fetch, upper nybble sets audio
     // -0 = Fast Fetch ON
     // -F = Fast Fetch OFF
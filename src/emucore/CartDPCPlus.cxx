@@ -15,9 +15,6 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
-#ifdef DEBUGGER_SUPPORT
-  #include "Debugger.hxx"
-#endif
 #include "System.hxx"
 #include "Thumbulator.hxx"
 #include "CartDPCPlus.hxx"
@@ -26,14 +23,11 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeDPCPlus::CartridgeDPCPlus(const BytePtr& image, uInt32 size,
                                    const Settings& settings)
-  : Cartridge(settings),
+  : CartridgeARM(settings),
     mySize(std::min(size, 32768u)),
     myFastFetch(false),
     myLDAimmediate(false),
     myParameterPointer(0),
-    myAudioCycles(0),
-    myARMCycles(0),
-    myFractionalClocks(0.0),
     myBankOffset(0)
 {
   // Image is always 32K, but in the case of ROM > 29K, the image is
@@ -47,19 +41,13 @@ CartridgeDPCPlus::CartridgeDPCPlus(const BytePtr& image, uInt32 size,
   myProgramImage = myImage + 0xC00;
 
   // Pointer to the display RAM
-  myDisplayImage = myDPCRAM + 0xC00;
+  myDisplayImage = myRAM + 0xC00;
 
   // Pointer to the Frequency RAM
   myFrequencyImage = myDisplayImage + 0x1000;
 
   // Create Thumbulator ARM emulator
-  const string& prefix = settings.getBool("dev.settings") ? "dev." : "plr.";
-  myThumbEmulator = make_unique<Thumbulator>
-      (reinterpret_cast<uInt16*>(myImage),
-       reinterpret_cast<uInt16*>(myDPCRAM),
-       settings.getBool(prefix + "thumb.trapfatal"),
-       Thumbulator::ConfigureFor::DPCplus,
-       this);
+  createThumbulator(myImage, Thumbulator::ConfigureFor::DPCplus);
 
   setInitialState();
 }
@@ -67,8 +55,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const BytePtr& image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPCPlus::reset()
 {
-  myAudioCycles = myARMCycles = 0;
-  myFractionalClocks = 0.0;
+  resetARM();
 
   setInitialState();
 
@@ -83,7 +70,7 @@ void CartridgeDPCPlus::reset()
 void CartridgeDPCPlus::setInitialState()
 {
   // Reset various ROM and RAM locations
-  memset(myDPCRAM, 0, 8192);
+  memset(myRAM, 0, 8192);
 
   // Copy initial DPC display data and Frequency table state to Harmony RAM
   memcpy(myDisplayImage, myProgramImage + 0x6000, 0x1400);
@@ -103,12 +90,6 @@ void CartridgeDPCPlus::setInitialState()
   myRandomNumber = 0x2B435044; // "DPC+"
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void CartridgeDPCPlus::consoleChanged(ConsoleTiming timing)
-{
-  myThumbEmulator->setConsoleTiming(timing);
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPCPlus::install(System& system)
 {
@@ -140,24 +121,6 @@ inline void CartridgeDPCPlus::priorClockRandomNumberGenerator()
     (myRandomNumber << 11) | (myRandomNumber >> 21));
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
-{
-  // Calculate the number of cycles since the last update
-  uInt32 cycles = uInt32(mySystem->cycles() - myAudioCycles);
-  myAudioCycles = mySystem->cycles();
-
-  // Calculate the number of DPC+ OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
-
-  // Let's update counters and flags of the music mode data fetchers
-  if(wholeClocks > 0)
-    for(int x = 0; x <= 2; ++x)
-      myMusicCounters[x] += myMusicFrequencies[x] * wholeClocks;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void CartridgeDPCPlus::callFunction(uInt8 value)
 {
@@ -179,25 +142,11 @@ inline void CartridgeDPCPlus::callFunction(uInt8 value)
       myParameterPointer = 0;
       break;
       // Call user written ARM code (most likely be C compiled for ARM)
-    case 254: // call with IRQ driven audio, no special handling needed at this
-              // time for Stella as ARM code "runs in zero 6507 cycles".
+    case 254: // call with IRQ driven audio
+      runARM(true);
+      break;
     case 255: // call without IRQ driven audio
-      try {
-        Int32 cycles = Int32(mySystem->cycles() - myARMCycles);
-        myARMCycles = mySystem->cycles();
-
-        myThumbEmulator->run(cycles);
-      }
-      catch(const runtime_error& e) {
-        if(!mySystem->autodetectMode())
-        {
-      #ifdef DEBUGGER_SUPPORT
-          Debugger::debugger().startWithFatalError(e.what());
-      #else
-          cout << e.what() << endl;
-      #endif
-        }
-      }
+      runARM(false);
       break;
     // reserved
   }
@@ -229,6 +178,11 @@ uInt8 CartridgeDPCPlus::peek(uInt16 address)
   {
     uInt8 result = 0;
 
+    // The data fetchers read RAM which the ARM code may be modifying
+    // (AMPLITUDE is synced separately, see updateMusicModeDataFetchers())
+    if(address != 0x05)
+      syncARM();
+
     // Get the index of the data fetcher that's being accessed
     uInt32 index = address & 0x07;
     uInt32 function = (address >> 3) & 0x07;
@@ -392,6 +346,9 @@ bool CartridgeDPCPlus::poke(uInt16 address, uInt8 value)
 
   if((address >= 0x0028) && (address < 0x0080))
   {
+    // The data fetchers write RAM which the ARM code may be modifying
+    syncARM();
+
     // Get the index of the data fetcher that's being accessed
     uInt32 index = address & 0x07;
     uInt32 function = ((address - 0x28) >> 3) & 0x0f;
@@ -631,14 +588,14 @@ const uInt8* CartridgeDPCPlus::getImage(uInt32& size) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeDPCPlus::save(Serializer& out) const
 {
+  if(!CartridgeARM::save(out))
+    return false;
+
   try
   {
     // Indicates which bank is currently active
     out.putShort(myBankOffset);
 
-    // Harmony RAM
-    out.putByteArray(myDPCRAM, 8192);
-
     // The top registers for the data fetchers
     out.putByteArray(myTops, 8);
 
@@ -661,24 +618,11 @@ bool CartridgeDPCPlus::save(Serializer& out) const
     // Control Byte to update
     out.putByteArray(myParameter, 8);
 
-    // The music counters
-    out.putIntArray(myMusicCounters, 3);
-
-    // The music frequencies
-    out.putIntArray(myMusicFrequencies, 3);
-
     // The music waveforms
     out.putShortArray(myMusicWaveforms, 3);
 
     // The random number generator register
     out.putInt(myRandomNumber);
-
-    // Get system cycles and fractional clocks
-    out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
-
-    // Clock info for Thumbulator
-    out.putLong(myARMCycles);
   }
   catch(...)
   {
@@ -692,14 +636,14 @@ bool CartridgeDPCPlus::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeDPCPlus::load(Serializer& in)
 {
+  if(!CartridgeARM::load(in))
+    return false;
+
   try
   {
     // Indicates which bank is currently active
     myBankOffset = in.getShort();
 
-    // Harmony RAM
-    in.getByteArray(myDPCRAM, 8192);
-
     // The top registers for the data fetchers
     in.getByteArray(myTops, 8);
 
@@ -722,24 +666,11 @@ bool CartridgeDPCPlus::load(Serializer& in)
     // Control Byte to update
     in.getByteArray(myParameter, 8);
 
-    // The music mode counters for the data fetchers
-    in.getIntArray(myMusicCounters, 3);
-
-    // The music mode frequency addends for the data fetchers
-    in.getIntArray(myMusicFrequencies, 3);
-
     // The music waveforms
     in.getShortArray(myMusicWaveforms, 3);
 
     // The random number generator register
     myRandomNumber = in.getInt();
-
-    // Get audio cycles and fractional clocks
-    myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
-
-    // Clock info for Thumbulator
-    myARMCycles = in.getLong();
   }
   catch(...)
   {
@@ -18,15 +18,12 @@
 #ifndef CARTRIDGE_DPC_PLUS_HXX
 #define CARTRIDGE_DPC_PLUS_HXX
 
-class System;
-
-#include "Thumbulator.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartDPCPlusWidget.hxx"
 #endif
 
 #include "bspf.hxx"
-#include "Cart.hxx"
+#include "CartARM.hxx"
 
 /**
   Cartridge class used for DPC+, derived from Pitfall II.  There are six 4K
@@ -42,7 +39,7 @@ class System;
 
   @authors  Darrell Spice Jr, Fred Quimby, Stephen Anthony, Bradford W. Mott
 */
-class CartridgeDPCPlus : public Cartridge
+class CartridgeDPCPlus : public CartridgeARM
 {
   friend class CartridgeDPCPlusWidget;
 	friend class CartridgeRamDPCPlusWidget;
@@ -64,15 +61,6 @@ class CartridgeDPCPlus : public Cartridge
     */
     void reset() override;
 
-    /**
-      Notification method invoked by the system when the console type
-      has changed.  We need this to inform the Thumbulator that the
-      timing has changed.
-
-      @param timing  Enum representing the new console type
-    */
-    void consoleChanged(ConsoleTiming timing) override;
-
     /**
       Install cartridge in the specified system.  Invoked by the system
       when the cartridge is attached to it.
@@ -183,12 +171,6 @@ class CartridgeDPCPlus : public Cartridge
     */
     void priorClockRandomNumberGenerator();
 
-    /**
-      Updates any data fetchers in music mode based on the number of
-      CPU cycles which have passed since the last update.
-    */
-    void updateMusicModeDataFetchers();
-
     /**
       Call Special Functions
     */
@@ -202,19 +184,11 @@ class CartridgeDPCPlus : public Cartridge
     // Pointer to the 24K program ROM image of the cartridge
     uInt8* myProgramImage;
 
-    // Pointer to the 4K display ROM image of the cartridge
-    uInt8* myDisplayImage;
-
-    // The DPC 8k RAM image, used as:
+    // Pointer to the 1K frequency table
+    // The DPC 8k RAM image is used as:
     //   3K DPC+ driver
     //   4K Display Data
     //   1K Frequency Data
-    uInt8 myDPCRAM[8192];
-
-    // Pointer to the Thumb ARM emulator object
-    unique_ptr<Thumbulator> myThumbEmulator;
-
-    // Pointer to the 1K frequency table
     uInt8* myFrequencyImage;
 
     // The top registers for the data fetchers
@@ -244,26 +218,12 @@ class CartridgeDPCPlus : public Cartridge
     // Parameter pointer for special functions
     uInt8 myParameterPointer;
 
-    // The music mode counters
-    uInt32 myMusicCounters[3];
-
-    // The music frequency
-    uInt32 myMusicFrequencies[3];
-
     // The music waveforms
     uInt16 myMusicWaveforms[3];
 
     // The random number generator register
     uInt32 myRandomNumber;
 
-    // System cycle count from when the last update to music data fetchers occurred
-    uInt64 myAudioCycles;
-
-    // System cycle count when the last Thumbulator::run() occurred
-    uInt64 myARMCycles;
-
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
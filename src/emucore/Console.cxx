@@ -634,12 +634,23 @@ void Console::initializeAudio()
     .updateAudioQueueHeadroom(myAudioSettings.headroom())
     .updateSpeedFactor(myOSystem.settings().getFloat("speed"));
 
-  createAudioQueue();
+  createAudioQueue(myEmulationTiming.audioQueueCapacity());
   myTIA->setAudioQueue(myAudioQueue);
 
   myOSystem.sound().open(myAudioQueue, &myEmulationTiming);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<AudioQueue> Console::redirectAudio(uInt32 capacity)
+{
+  myOSystem.sound().close();
+
+  createAudioQueue(capacity);
+  myTIA->setAudioQueue(myAudioQueue);
+
+  return myAudioQueue;
+}
+
 /* Original frying research and code by Fred Quimby.
    I've tried the following variations on this code:
    - Both OR and Exclusive OR instead of AND. This generally crashes the game
@@ -808,7 +819,7 @@ void Console::setTIAProperties()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Console::createAudioQueue()
+void Console::createAudioQueue(uInt32 capacity)
 {
   const string& stereo = myOSystem.settings().getString(AudioSettings::SETTING_STEREO);
   bool useStereo = false;
@@ -819,7 +830,7 @@ void Console::createAudioQueue()
 
   myAudioQueue = make_shared<AudioQueue>(
     myEmulationTiming.audioFragmentSize(),
-    myEmulationTiming.audioQueueCapacity(),
+    capacity,
     useStereo
   );
 }
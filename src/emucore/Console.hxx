@@ -181,6 +181,11 @@ class Console : public Serializable
      */
     EmulationTiming& emulationTiming() { return myEmulationTiming; }
 
+    /**
+      Get the audio queue the TIA currently writes to.
+    */
+    shared_ptr<AudioQueue> audioQueue() const { return myAudioQueue; }
+
   public:
     /**
       Toggle between NTSC/PAL/SECAM (and variants) display format.
@@ -241,6 +246,16 @@ class Console : public Serializable
     */
     void initializeAudio();
 
+    /**
+      Close the sound device, and let the TIA write its audio to a new
+      queue instead, e.g. to render the audio offline.  Call
+      initializeAudio() to restore normal playback.
+
+      @param capacity  The capacity of the new queue (in fragments)
+      @return  The new audio queue
+    */
+    shared_ptr<AudioQueue> redirectAudio(uInt32 capacity);
+
     /**
       "Fry" the Atari (mangle memory/TIA contents)
     */
@@ -331,8 +346,10 @@ class Console : public Serializable
 
     /**
       Create the audio queue
+
+      @param capacity  The capacity of the queue (in fragments)
      */
-    void createAudioQueue();
+    void createAudioQueue(uInt32 capacity);
 
     /**
       Adds the left and right controllers to the console.
@@ -32,6 +32,7 @@ EmulationWorker::EmulationWorker()
     myMaxCycles(0),
     myMinCycles(0),
     myDispatchResult(nullptr),
+    mySingleTimeslice(false),
     myTotalCycles(0)
 {
   std::mutex mutex;
@@ -77,7 +78,7 @@ void EmulationWorker::handlePossibleException()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia)
+void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia, bool singleTimeslice)
 {
   // Wait until any pending signal has been processed
   waitUntilPendingSignalHasProcessed();
@@ -105,6 +106,7 @@ void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 min
     myMaxCycles = maxCycles;
     myMinCycles = minCycles;
     myDispatchResult = dispatchResult;
+    mySingleTimeslice = singleTimeslice;
 
     // Raise the signal...
     myPendingSignal = Signal::resume;
@@ -246,7 +248,10 @@ void EmulationWorker::handleWakeupFromWaitingForStop(std::unique_lock<std::mutex
       break;
 
     case Signal::none:
-      if (myVirtualTime <= high_resolution_clock::now())
+      if (mySingleTimeslice)
+        // Only a single timeslice was requested -> sleep until we are stopped
+        myWakeupCondition.wait(lock);
+      else if (myVirtualTime <= high_resolution_clock::now())
         // The time allotted to the emulation timeslice has passed and we haven't been stopped?
         // -> go for another emulation timeslice
         dispatchEmulation(lock);
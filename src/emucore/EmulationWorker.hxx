@@ -66,8 +66,10 @@ class EmulationWorker
 
     /**
       Wake up the worker and start emulation with the specified parameters.
+      If singleTimeslice is set, the worker emulates exactly one timeslice and
+      then idles until it is stopped (used for movie recording and playback).
      */
-    void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia);
+    void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia, bool singleTimeslice = false);
 
     /**
       Stop emulation and return the number of 6507 cycles emulated.
@@ -193,6 +195,7 @@ class EmulationWorker
     uInt64 myMaxCycles;
     uInt64 myMinCycles;
     DispatchResult* myDispatchResult;
+    bool mySingleTimeslice;
 
     // Total number of cycles during this emulation run
     uInt64 myTotalCycles;
@@ -207,7 +207,9 @@ void EventHandler::poll(uInt64 time)
   // related to emulation
   if(myState == EventHandlerState::EMULATION)
   {
-    myOSystem.console().riot().update();
+    // During movie playback, the input comes from the movie instead
+    if(myOSystem.state().mode() != StateManager::Mode::MoviePlayback)
+      myOSystem.console().riot().update();
 
     // Now check if the StateManager should be saving or loading state
     // (for rewind and/or movies
@@ -1098,6 +1100,9 @@ bool EventHandler::enterDebugMode()
   if(myState == EventHandlerState::DEBUGGER || !myOSystem.hasConsole())
     return false;
 
+  // Stepping and editing the state in the debugger would break any movie
+  myOSystem.state().interruptMovie();
+
   // Make sure debugger starts in a consistent state
   // This absolutely *has* to come before we actually change to debugger
   // mode, since it takes care of locking the debugger state, which will
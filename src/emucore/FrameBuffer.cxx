@@ -243,7 +243,7 @@ FBInitStatus FrameBuffer::createDisplay(const string& title,
   // Create surfaces for TIA statistics and general messages
   myStatsMsg.color = kColorInfo;
   myStatsMsg.w = font().getMaxCharWidth() * 40 + 3;
-  myStatsMsg.h = (font().getFontHeight() + 2) * 3;
+  myStatsMsg.h = (font().getFontHeight() + 2) * 5;
 
   if(!myStatsMsg.surface)
   {
@@ -465,6 +465,36 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
   ss << info.BankSwitch;
   if (myOSystem.settings().getBool("dev.settings")) ss << "| Developer";
 
+  myStatsMsg.surface->drawString(font(), ss.str(), xPos, yPos,
+                                 myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+
+  // draw audio pipeline statistics (of the last second)
+  const AudioStats::Snapshot& audio = myOSystem.audioStats();
+
+  yPos += dy;
+  ss.str("");
+
+  ss
+    << "Audio " << std::fixed << std::setprecision(1) << audio.meanFill()
+    << " [" << audio.fillPercentile(0.01) << ".." << audio.fillPercentile(0.99) << "]"
+    << " U:" << audio.underruns << " O:" << audio.overflows;
+
+  color = audio.underruns + audio.overflows > 0 ? kDbgColorRed : myStatsMsg.color;
+  myStatsMsg.surface->drawString(font(), ss.str(), xPos, yPos,
+                                 myStatsMsg.w, color, TextAlign::Left, 0, true, kBGColor);
+
+  yPos += dy;
+  ss.str("");
+
+  ss
+    << std::fixed << std::setprecision(0)
+    << "cb " << audio.meanTime(AudioStats::Timing::callback)
+    << "/" << audio.timePercentile(AudioStats::Timing::callback, 0.99) << "us"
+    << " rs " << audio.meanTime(AudioStats::Timing::resampling)
+    << "/" << audio.timePercentile(AudioStats::Timing::resampling, 0.99) << "us"
+    << " enq " << std::setprecision(1)
+    << audio.meanTime(AudioStats::Timing::enqueueInterval) / 1000 << "ms";
+
   myStatsMsg.surface->drawString(font(), ss.str(), xPos, yPos,
                                  myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
 
@@ -108,8 +108,38 @@ void M6532::update()
   port1.update();
   myConsole.switches().update();
 
+  detectPA7Edge(prevPA7);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6532::saveInput(Serializer& out) const
+{
+  return myConsole.leftController().save(out) &&
+         myConsole.rightController().save(out) &&
+         myConsole.switches().save(out);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6532::loadInput(Serializer& in)
+{
+  Controller& port0 = myConsole.leftController();
+
+  // Get current PA7 state
+  bool prevPA7 = port0.myDigitalPinState[Controller::Four];
+
+  if(!(port0.load(in) && myConsole.rightController().load(in) &&
+       myConsole.switches().load(in)))
+    return false;
+
+  detectPA7Edge(prevPA7);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::detectPA7Edge(bool prevPA7)
+{
   // Get new PA7 state
-  bool currPA7 = port0.myDigitalPinState[Controller::Four];
+  bool currPA7 = myConsole.leftController().myDigitalPinState[Controller::Four];
 
   // PA7 Flag is set on active transition in appropriate direction
   if((!myEdgeDetectPositive && prevPA7 && !currPA7) ||
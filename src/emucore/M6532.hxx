@@ -65,6 +65,17 @@ class M6532 : public Device
     */
     void update();
 
+    /**
+      Save/load the pin state of ports A and B, and of the console switches,
+      as set by the last update().  Loading has the same effect on the
+      6532 as the corresponding update() (used to replay recorded input).
+
+      @param out/in  The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool saveInput(Serializer& out) const;
+    bool loadInput(Serializer& in);
+
     /**
       Install 6532 in the specified system.  Invoked by the system
       when the 6532 is attached to it.
@@ -127,6 +138,7 @@ class M6532 : public Device
 
     void setTimerRegister(uInt8 data, uInt8 interval);
     void setPinState(bool shcha);
+    void detectPA7Edge(bool prevPA7);
 
     // The following are used by the debugger to read INTIM/TIMINT
     // We need separate methods to do this, so the state of the system
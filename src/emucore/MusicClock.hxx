@@ -0,0 +1,150 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MUSIC_CLOCK_HXX
+#define MUSIC_CLOCK_HXX
+
+#include "bspf.hxx"
+#include "Serializable.hxx"
+
+/**
+  Converts elapsed 6507 cycles into the 20 kHz OSC clocks that drive the
+  music mode data fetchers of the DPC+, CDF and BUS schemes.
+
+  The OSC runs at 20000 Hz, the 6507 at 3579575 / 3 Hz, so each 6507 cycle
+  corresponds to exactly 60000 / 3579575 OSC clocks.  Instead of carrying a
+  fractional 'double' between updates, the phase accumulator keeps the exact
+  remainder of that ratio.  As such, the result is identical on every
+  platform/compiler, and the division by a constant compiles down to a
+  multiply-and-shift.
+*/
+class MusicClock : public Serializable
+{
+  public:
+    MusicClock() : myCycles(0), myPhase(0) { }
+    virtual ~MusicClock() = default;
+
+    /**
+      Reset the clock to the beginning of time.
+    */
+    void reset() { myCycles = 0;  myPhase = 0; }
+
+    /**
+      Advance the clock to the given system cycle count.
+
+      @param cycles  The current system cycle count
+      @return  The number of whole OSC clocks since the last update
+    */
+    uInt32 advance(uInt64 cycles)
+    {
+      // Number of cycles since the last update (wraps exactly like the
+      // previous implementation did)
+      const uInt32 elapsed = uInt32(cycles - myCycles);
+      myCycles = cycles;
+
+      const uInt64 phase = uInt64(elapsed) * OSC_NUMERATOR + myPhase;
+      myPhase = uInt32(phase % OSC_DENOMINATOR);
+
+      return uInt32(phase / OSC_DENOMINATOR);
+    }
+
+    /**
+      Advance the clock to the given system cycle count, and clock the
+      three music mode data fetchers by the elapsed amount of OSC clocks.
+      Any number of clocks is handled in a single batch.
+
+      @param cycles       The current system cycle count
+      @param counters     The music counters to update
+      @param frequencies  The music frequencies to add to each counter
+    */
+    void update(uInt64 cycles, uInt32 counters[3], const uInt32 frequencies[3])
+    {
+      const uInt32 clocks = advance(cycles);
+
+      if(clocks > 0)
+      {
+        counters[0] += frequencies[0] * clocks;
+        counters[1] += frequencies[1] * clocks;
+        counters[2] += frequencies[2] * clocks;
+      }
+    }
+
+    /**
+      Save the current state of this clock to the given Serializer.
+
+      @param out  The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool save(Serializer& out) const override
+    {
+      try
+      {
+        out.putLong(myCycles);
+        out.putInt(myPhase);
+      }
+      catch(...)
+      {
+        cerr << "ERROR: MusicClock::save" << endl;
+        return false;
+      }
+
+      return true;
+    }
+
+    /**
+      Load the current state of this clock from the given Serializer.
+
+      @param in  The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool load(Serializer& in) override
+    {
+      try
+      {
+        myCycles = in.getLong();
+        myPhase = in.getInt() % OSC_DENOMINATOR;
+      }
+      catch(...)
+      {
+        cerr << "ERROR: MusicClock::load" << endl;
+        return false;
+      }
+
+      return true;
+    }
+
+  private:
+    // OSC clocks per 6507 cycle, as the exact ratio 20000 * 3 / 3579575
+    static constexpr uInt32 OSC_NUMERATOR   = 60000;
+    static constexpr uInt32 OSC_DENOMINATOR = 3579575;
+
+    // System cycle count from when the last update occurred
+    uInt64 myCycles;
+
+    // Remainder (in units of 1/OSC_DENOMINATOR OSC clocks) left over from
+    // the last update
+    uInt32 myPhase;
+
+  private:
+    // Following constructors and assignment operators not supported
+    MusicClock(const MusicClock&) = delete;
+    MusicClock(MusicClock&&) = delete;
+    MusicClock& operator=(const MusicClock&) = delete;
+    MusicClock& operator=(MusicClock&&) = delete;
+};
+
+#endif
@@ -50,12 +50,16 @@
 #include "Random.hxx"
 #include "SerialPort.hxx"
 #include "StateManager.hxx"
+#include "RewindManager.hxx"
 #include "TimerManager.hxx"
+#include "ThreadPool.hxx"
 #include "Version.hxx"
 #include "TIA.hxx"
 #include "DispatchResult.hxx"
 #include "EmulationWorker.hxx"
 #include "AudioSettings.hxx"
+#include "AudioQueue.hxx"
+#include "AudioRenderer.hxx"
 
 #include "OSystem.hxx"
 
@@ -69,7 +73,8 @@ namespace {
 OSystem::OSystem()
   : myLauncherUsed(false),
     myQuitLoop(false),
-    myFpsMeter(FPS_METER_QUEUE_SIZE)
+    myFpsMeter(FPS_METER_QUEUE_SIZE),
+    myAudioStatsSeconds(0)
 {
   // Get built-in features
   #ifdef SOUND_SUPPORT
@@ -120,6 +125,10 @@ bool OSystem::create()
       << FilesystemNode(myPropertiesFile).getShortPath() << "'" << endl;
   logMessage(buf.str(), 1);
 
+  // The framebuffer renders using the thread pool
+  myThreadPool = make_unique<ThreadPool>();
+  enableThreading(mySettings->getBool("threads"));
+
   // NOTE: The framebuffer MUST be created before any other object!!!
   // Get relevant information about the video hardware
   // This must be done before any graphics context is created, since
@@ -169,6 +178,14 @@ bool OSystem::create()
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::enableThreading(bool enable)
+{
+  const uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 1;
+
+  myThreadPool->resize(std::max(1u, std::min(4u, systemThreads)));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::loadConfig()
 {
@@ -331,6 +348,8 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
     myCheatManager->loadCheats(myRomMD5);
   #endif
     myEventHandler->reset(EventHandlerState::EMULATION);
+    // Continue the previous Time Machine session, unless the ROM is reloaded
+    myStateManager->rewindManager().openArchive(!showmessage);
     myEventHandler->setMouseControllerMode(mySettings->getString("usemouse"));
     if(createFrameBuffer() != FBInitStatus::Success)  // Takes care of initializeVideo()
     {
@@ -421,6 +440,28 @@ string OSystem::getROMInfo(const FilesystemNode& romfile)
   return getROMInfo(*console);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool OSystem::renderAudio(const FilesystemNode& romfile, const string& filename,
+                          double seconds)
+{
+  unique_ptr<Console> console;
+  try
+  {
+    string md5;
+    console = openConsole(romfile, md5);
+  }
+  catch(const runtime_error& e)
+  {
+    ostringstream buf;
+    buf << "ERROR: Couldn't create console (" << e.what() << ")";
+    logMessage(buf.str(), 0);
+    return false;
+  }
+
+  AudioRenderer renderer(*this);
+  return renderer.render(*console, filename, seconds);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::logMessage(const string& message, uInt8 level)
 {
@@ -603,6 +644,22 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
   EmulationTiming& timing(myConsole->emulationTiming());
   DispatchResult dispatchResult;
 
+  uInt64 maxCycles = timing.maxCyclesPerTimeslice();
+  uInt64 minCycles = timing.minCyclesPerTimeslice();
+
+  // During movies, input is sampled and applied between timeslices, so the
+  // worker must not continue on its own; on playback, the timeslice must
+  // also end exactly when the next input change is due
+  const StateManager::Mode mode = myStateManager->mode();
+  const bool singleTimeslice = mode == StateManager::Mode::MovieRecord ||
+                               mode == StateManager::Mode::MoviePlayback;
+  if(mode == StateManager::Mode::MoviePlayback &&
+     myStateManager->nextMovieCycles() > tia.cycles())
+  {
+    maxCycles = std::min(maxCycles, myStateManager->nextMovieCycles() - tia.cycles());
+    minCycles = std::min(minCycles, maxCycles);
+  }
+
   // Check whether we have a frame pending for rendering...
   bool framePending = tia.newFramePending();
   // ... and copy it to the frame buffer. It is important to do this before
@@ -616,10 +673,11 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
   // and will run until we stop the worker.
   emulationWorker.start(
     timing.cyclesPerSecond(),
-    timing.maxCyclesPerTimeslice(),
-    timing.minCyclesPerTimeslice(),
+    maxCycles,
+    minCycles,
     &dispatchResult,
-    &tia
+    &tia,
+    singleTimeslice
   );
 
   // Render the frame. This may block, but emulation will continue to run on the worker, so the
@@ -646,6 +704,40 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
   return static_cast<double>(totalCycles) / static_cast<double>(timing.cyclesPerSecond());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::updateAudioStats()
+{
+  if(!myConsole || !myConsole->audioQueue()) return;
+
+  const steady_clock::time_point now = steady_clock::now();
+  const shared_ptr<AudioQueue> queue = myConsole->audioQueue();
+
+  // Start over whenever the audio is (re)initialized
+  if(queue != myAudioStatsQueue)
+  {
+    myAudioStatsQueue = queue;
+    myAudioStatsLast = myAudioStatsLogged = queue->stats().snapshot();
+    myAudioStatsWindow = AudioStats::Snapshot();
+    myAudioStatsTime = now;
+    myAudioStatsSeconds = 0;
+    return;
+  }
+  if(now - myAudioStatsTime < seconds(1)) return;
+
+  const AudioStats::Snapshot snapshot = queue->stats().snapshot();
+  myAudioStatsWindow = snapshot - myAudioStatsLast;
+  myAudioStatsLast = snapshot;
+  myAudioStatsTime = now;
+
+  const uInt32 interval = mySettings->getInt(AudioSettings::SETTING_STATS);
+  if(interval > 0 && ++myAudioStatsSeconds >= interval)
+  {
+    logMessage("Audio: " + (snapshot - myAudioStatsLogged).summary(), 1);
+    myAudioStatsLogged = snapshot;
+    myAudioStatsSeconds = 0;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::mainLoop()
 {
@@ -670,9 +762,11 @@ void OSystem::mainLoop()
 
     double timesliceSeconds;
 
-    if (myEventHandler->state() == EventHandlerState::EMULATION)
+    if (myEventHandler->state() == EventHandlerState::EMULATION) {
       // Dispatch emulation and render frame (if applicable)
       timesliceSeconds = dispatchEmulation(emulationWorker);
+      updateAudioStats();
+    }
     else {
       // Render the GUI with 60 Hz in all other modes
       timesliceSeconds = 1. / 60.;
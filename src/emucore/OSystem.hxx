@@ -38,9 +38,11 @@ class Settings;
 class Sound;
 class StateManager;
 class TimerManager;
+class ThreadPool;
 class VideoDialog;
 class EmulationWorker;
 class AudioSettings;
+class AudioQueue;
 
 #include <chrono>
 
@@ -48,6 +50,7 @@ class AudioSettings;
 #include "FrameBufferConstants.hxx"
 #include "EventHandlerConstants.hxx"
 #include "FpsMeter.hxx"
+#include "AudioStats.hxx"
 #include "bspf.hxx"
 
 /**
@@ -180,6 +183,21 @@ class OSystem
     */
     TimerManager& timer() const { return *myTimerManager; }
 
+    /**
+      Get the worker threads shared by the per-frame video stages.
+
+      @return The threadpool object
+    */
+    ThreadPool& threadPool() const { return *myThreadPool; }
+
+    /**
+      Size the thread pool: up to four threads when enabled, only the
+      calling thread otherwise.
+
+      @param enable  Whether to use multi-threaded rendering
+    */
+    void enableThreading(bool enable);
+
     /**
       Get the PNG handler of the system.
 
@@ -330,6 +348,18 @@ class OSystem
     */
     string getROMInfo(const FilesystemNode& romfile);
 
+    /**
+      Renders the audio of the given ROM to a WAV file, using a temporary
+      Console object (so no framebuffer is created).
+
+      @param romfile   The file node of the ROM to use
+      @param filename  The name of the WAV file
+      @param seconds   The emulated time to render
+      @return  False on any errors, else true
+    */
+    bool renderAudio(const FilesystemNode& romfile, const string& filename,
+                     double seconds);
+
     /**
       The features which are conditionally compiled into Stella.
 
@@ -390,6 +420,11 @@ class OSystem
 
     float frameRate() const;
 
+    /**
+      The statistics of the audio pipeline during the last second.
+    */
+    const AudioStats::Snapshot& audioStats() const { return myAudioStatsWindow; }
+
     /**
       This method runs the main loop.  Since different platforms
       may use different timing methods and/or algorithms, this method can
@@ -482,6 +517,9 @@ class OSystem
     // Pointer to the TimerManager object
     unique_ptr<TimerManager> myTimerManager;
 
+    // Pointer to the ThreadPool object
+    unique_ptr<ThreadPool> myThreadPool;
+
     // PNG object responsible for loading/saving PNG images
     unique_ptr<PNGLibrary> myPNGLib;
 
@@ -512,6 +550,15 @@ class OSystem
 
     FpsMeter myFpsMeter;
 
+    // The audio queue the statistics are taken from, the statistics at the
+    // start of the current second/log interval, and those of the last second
+    shared_ptr<AudioQueue> myAudioStatsQueue;
+    AudioStats::Snapshot myAudioStatsLast;
+    AudioStats::Snapshot myAudioStatsLogged;
+    AudioStats::Snapshot myAudioStatsWindow;
+    std::chrono::steady_clock::time_point myAudioStatsTime;
+    uInt32 myAudioStatsSeconds;
+
   private:
     /**
       Creates the various framebuffers/renderers available in this system.
@@ -577,6 +624,12 @@ class OSystem
 
     double dispatchEmulation(EmulationWorker& emulationWorker);
 
+    /**
+      Update the audio statistics of the last second (and log them, if
+      enabled by the 'audio.stats' setting).
+    */
+    void updateAudioStats();
+
     // Following constructors and assignment operators not supported
     OSystem(const OSystem&) = delete;
     OSystem(OSystem&&) = delete;
@@ -23,7 +23,10 @@ using std::ios_base;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer(const string& filename, bool readonly)
-  : myStream(nullptr)
+  : myStream(nullptr),
+    myInMemory(false),
+    myReadPos(0),
+    myWritePos(0)
 {
   if(readonly)
   {
@@ -63,89 +66,31 @@ Serializer::Serializer(const string& filename, bool readonly)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer()
-  : myStream(nullptr)
+  : myStream(nullptr),
+    myInMemory(true),
+    myReadPos(0),
+    myWritePos(0)
 {
-  myStream = make_unique<stringstream>(ios::in | ios::out | ios::binary);
-
-  // For some reason, Windows and possibly OSX needs to store something in
-  // the stream before it is used for the first time
-  if(myStream)
-  {
-    myStream->exceptions( ios_base::failbit | ios_base::badbit | ios_base::eofbit );
-    putBool(true);
-    rewind();
-  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::rewind()
 {
+  if(myInMemory)
+  {
+    myReadPos = myWritePos = 0;
+    return;
+  }
+
   myStream->clear();
   myStream->seekg(ios_base::beg);
   myStream->seekp(ios_base::beg);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 Serializer::getByte() const
-{
-  char buf;
-  myStream->read(&buf, 1);
-
-  return buf;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getByteArray(uInt8* array, uInt32 size) const
-{
-  myStream->read(reinterpret_cast<char*>(array), size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt16 Serializer::getShort() const
-{
-  uInt16 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt16));
-
-  return val;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getShortArray(uInt16* array, uInt32 size) const
+uInt32 Serializer::size() const
 {
-  myStream->read(reinterpret_cast<char*>(array), sizeof(uInt16)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Serializer::getInt() const
-{
-  uInt32 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt32));
-
-  return val;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getIntArray(uInt32* array, uInt32 size) const
-{
-  myStream->read(reinterpret_cast<char*>(array), sizeof(uInt32)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt64 Serializer::getLong() const
-{
-  uInt64 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt64));
-
-  return val;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Serializer::getDouble() const
-{
-  double val = 0.0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(double));
-
-  return val;
+  return uInt32(myInMemory ? myWritePos : size_t(myStream->tellp()));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -154,75 +99,15 @@ string Serializer::getString() const
   int len = getInt();
   string str;
   str.resize(len);
-  myStream->read(&str[0], len);
+  read(&str[0], len);
 
   return str;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Serializer::getBool() const
-{
-  return getByte() == TruePattern;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByte(uInt8 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), 1);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByteArray(const uInt8* array, uInt32 size)
-{
-  myStream->write(reinterpret_cast<const char*>(array), size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShort(uInt16 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt16));
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShortArray(const uInt16* array, uInt32 size)
-{
-  myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt16)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putInt(uInt32 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt32));
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putIntArray(const uInt32* array, uInt32 size)
-{
-  myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt32)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putLong(uInt64 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt64));
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putDouble(double value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(double));
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putString(const string& str)
 {
   int len = int(str.length());
   putInt(len);
-  myStream->write(str.data(), len);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putBool(bool b)
-{
-  putByte(b ? TruePattern: FalsePattern);
+  write(str.data(), len);
 }
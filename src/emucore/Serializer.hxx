@@ -30,6 +30,11 @@
   strings are written as characters prepended by the length of the string,
   boolean values are written using a special character pattern.
 
+  The in-memory structure is a contiguous byte buffer, which is accessed
+  inline (without going through a stream), and can be directly accessed
+  with data() and size().  It only grows, so once it has the size of a
+  state, it can be reused without any further allocations.
+
   @author  Stephen Anthony
 */
 class Serializer
@@ -54,19 +59,41 @@ class Serializer
       Answers whether the serializer is currently initialized for reading
       and writing.
     */
-    explicit operator bool() const { return myStream != nullptr; }
+    explicit operator bool() const { return myStream != nullptr || myInMemory; }
 
     /**
       Resets the read/write location to the beginning of the stream.
     */
     void rewind();
 
+    /**
+      Answers the current write position, which for an in-memory stream
+      is the number of bytes written since the last rewind().
+    */
+    uInt32 size() const;
+
+    /**
+      Answers the contents of an in-memory stream (the first size() bytes
+      are those written since the last rewind()), or nullptr for files.
+    */
+    const uInt8* data() const { return myInMemory ? myBuffer.data() : nullptr; }
+
+    /**
+      Reserve space for an in-memory stream of the given size, so that
+      writing that many bytes won't need any allocations.
+    */
+    void reserve(uInt32 size) { if(myInMemory) myBuffer.reserve(size); }
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
       @result The byte value which has been read from the stream.
     */
-    uInt8 getByte() const;
+    uInt8 getByte() const {
+      uInt8 val;
+      read(&val, 1);
+      return val;
+    }
 
     /**
       Reads a byte array (unsigned 8-bit) from the current input stream.
@@ -74,14 +101,20 @@ class Serializer
       @param array  The location to store the bytes read
       @param size   The size of the array (number of bytes to read)
     */
-    void getByteArray(uInt8* array, uInt32 size) const;
+    void getByteArray(uInt8* array, uInt32 size) const {
+      read(array, size);
+    }
 
     /**
       Reads a short value (unsigned 16-bit) from the current input stream.
 
       @result The short value which has been read from the stream.
     */
-    uInt16 getShort() const;
+    uInt16 getShort() const {
+      uInt16 val;
+      read(&val, sizeof(uInt16));
+      return val;
+    }
 
     /**
       Reads a short array (unsigned 16-bit) from the current input stream.
@@ -89,14 +122,20 @@ class Serializer
       @param array  The location to store the shorts read
       @param size   The size of the array (number of shorts to read)
     */
-    void getShortArray(uInt16* array, uInt32 size) const;
+    void getShortArray(uInt16* array, uInt32 size) const {
+      read(array, sizeof(uInt16)*size);
+    }
 
     /**
       Reads an int value (unsigned 32-bit) from the current input stream.
 
       @result The int value which has been read from the stream.
     */
-    uInt32 getInt() const;
+    uInt32 getInt() const {
+      uInt32 val;
+      read(&val, sizeof(uInt32));
+      return val;
+    }
 
     /**
       Reads an integer array (unsigned 32-bit) from the current input stream.
@@ -104,21 +143,31 @@ class Serializer
       @param array  The location to store the integers read
       @param size   The size of the array (number of integers to read)
     */
-    void getIntArray(uInt32* array, uInt32 size) const;
+    void getIntArray(uInt32* array, uInt32 size) const {
+      read(array, sizeof(uInt32)*size);
+    }
 
     /**
       Reads a long int value (unsigned 64-bit) from the current input stream.
 
       @result The long int value which has been read from the stream.
     */
-    uInt64 getLong() const;
+    uInt64 getLong() const {
+      uInt64 val;
+      read(&val, sizeof(uInt64));
+      return val;
+    }
 
     /**
       Reads a double value (signed 64-bit) from the current input stream.
 
       @result The double value which has been read from the stream.
     */
-    double getDouble() const;
+    double getDouble() const {
+      double val;
+      read(&val, sizeof(double));
+      return val;
+    }
 
     /**
       Reads a string from the current input stream.
@@ -132,14 +181,16 @@ class Serializer
 
       @result The boolean value which has been read from the stream.
     */
-    bool getBool() const;
+    bool getBool() const { return getByte() == TruePattern; }
 
     /**
       Writes an byte value (unsigned 8-bit) to the current output stream.
 
       @param value The byte value to write to the output stream.
     */
-    void putByte(uInt8 value);
+    void putByte(uInt8 value) {
+      write(&value, 1);
+    }
 
     /**
       Writes a byte array (unsigned 8-bit) to the current output stream.
@@ -147,14 +198,18 @@ class Serializer
       @param array  The bytes to write
       @param size   The size of the array (number of bytes to write)
     */
-    void putByteArray(const uInt8* array, uInt32 size);
+    void putByteArray(const uInt8* array, uInt32 size) {
+      write(array, size);
+    }
 
     /**
       Writes a short value (unsigned 16-bit) to the current output stream.
 
       @param value The short value to write to the output stream.
     */
-    void putShort(uInt16 value);
+    void putShort(uInt16 value) {
+      write(&value, sizeof(uInt16));
+    }
 
     /**
       Writes a short array (unsigned 16-bit) to the current output stream.
@@ -162,14 +217,18 @@ class Serializer
       @param array  The short to write
       @param size   The size of the array (number of shorts to write)
     */
-    void putShortArray(const uInt16* array, uInt32 size);
+    void putShortArray(const uInt16* array, uInt32 size) {
+      write(array, sizeof(uInt16)*size);
+    }
 
     /**
       Writes an int value (unsigned 32-bit) to the current output stream.
 
       @param value The int value to write to the output stream.
     */
-    void putInt(uInt32 value);
+    void putInt(uInt32 value) {
+      write(&value, sizeof(uInt32));
+    }
 
     /**
       Writes an integer array (unsigned 32-bit) to the current output stream.
@@ -177,21 +236,27 @@ class Serializer
       @param array  The integers to write
       @param size   The size of the array (number of integers to write)
     */
-    void putIntArray(const uInt32* array, uInt32 size);
+    void putIntArray(const uInt32* array, uInt32 size) {
+      write(array, sizeof(uInt32)*size);
+    }
 
     /**
       Writes a long int value (unsigned 64-bit) to the current output stream.
 
       @param value The long int value to write to the output stream.
     */
-    void putLong(uInt64 value);
+    void putLong(uInt64 value) {
+      write(&value, sizeof(uInt64));
+    }
 
     /**
       Writes a double value (signed 64-bit) to the current output stream.
 
       @param value The double value to write to the output stream.
     */
-    void putDouble(double value);
+    void putDouble(double value) {
+      write(&value, sizeof(double));
+    }
 
     /**
       Writes a string to the current output stream.
@@ -205,12 +270,48 @@ class Serializer
 
       @param b The boolean value to write to the output stream.
     */
-    void putBool(bool b);
+    void putBool(bool b) { putByte(b ? TruePattern: FalsePattern); }
 
   private:
-    // The stream to send the serialized data to.
+    /**
+      Read/write raw data from/to the in-memory buffer or the stream.
+      Reading past the end of the data throws an exception, as the file
+      streams do.
+    */
+    void read(void* data, size_t size) const {
+      if(myInMemory)
+      {
+        if(size > myBuffer.size() - myReadPos)
+          throw runtime_error("Serializer: read past end of data");
+        memcpy(data, myBuffer.data() + myReadPos, size);
+        myReadPos += size;
+      }
+      else
+        myStream->read(static_cast<char*>(data), size);
+    }
+    void write(const void* data, size_t size) {
+      if(myInMemory)
+      {
+        if(size > myBuffer.size() - myWritePos)
+          myBuffer.resize(myWritePos + size);
+        memcpy(myBuffer.data() + myWritePos, data, size);
+        myWritePos += size;
+      }
+      else
+        myStream->write(static_cast<const char*>(data), size);
+    }
+
+  private:
+    // The stream to send the serialized data to (files only)
     unique_ptr<iostream> myStream;
 
+    // The buffer holding the serialized data (in-memory only), and the
+    // current read/write positions within it
+    bool myInMemory;
+    ByteArray myBuffer;
+    mutable size_t myReadPos;
+    size_t myWritePos;
+
     enum {
       TruePattern  = 0xfe,
       FalsePattern = 0x01
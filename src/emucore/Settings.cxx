@@ -78,6 +78,8 @@ Settings::Settings(OSystem& osystem)
   setInternal(AudioSettings::SETTING_BUFFER_SIZE, AudioSettings::DEFAULT_BUFFER_SIZE);
   setInternal(AudioSettings::SETTING_HEADROOM, AudioSettings::DEFAULT_HEADROOM);
   setInternal(AudioSettings::SETTING_RESAMPLING_QUALITY, static_cast<int>(AudioSettings::DEFAULT_RESAMPLING_QUALITY));
+  setInternal(AudioSettings::SETTING_DYNAMIC_RATE, AudioSettings::DEFAULT_DYNAMIC_RATE);
+  setInternal(AudioSettings::SETTING_STATS, AudioSettings::DEFAULT_STATS);
 
   // Input event options
   setInternal("keymap", "");
@@ -136,6 +138,7 @@ Settings::Settings(OSystem& osystem)
   setInternal("avoxport", "");
   setInternal("fastscbios", "true");
   setInternal("threads", "false");
+  setInternal("armthread", "false");
   setExternal("romloadcount", "0");
   setExternal("maxres", "");
 
@@ -164,11 +167,14 @@ Settings::Settings(OSystem& osystem)
   setInternal("plr.console", "2600"); // 7800
   setInternal("plr.timemachine", false);
   setInternal("plr.tm.size", 100);
+  setInternal("plr.tm.memory", 256); // in MB
   setInternal("plr.tm.uncompressed", 30);
   setInternal("plr.tm.interval", "30f"); // = 0.5 seconds
   setInternal("plr.tm.horizon", "10m"); // = ~10 minutes
+  setInternal("plr.tm.archive", "false");
   // Thumb ARM emulation options
   setInternal("plr.thumb.trapfatal", "false");
+  setInternal("plr.thumb.trapoverrun", "false");
   setInternal("plr.eepromaccess", "false");
 
   // developer settings
@@ -185,11 +191,14 @@ Settings::Settings(OSystem& osystem)
   setInternal("dev.console", "2600"); // 7800
   setInternal("dev.timemachine", true);
   setInternal("dev.tm.size", 100);
+  setInternal("dev.tm.memory", 256); // in MB
   setInternal("dev.tm.uncompressed", 60);
   setInternal("dev.tm.interval", "1f"); // = 1 frame
   setInternal("dev.tm.horizon", "10s"); // = ~10 seconds
+  setInternal("dev.tm.archive", "false");
   // Thumb ARM emulation options
   setInternal("dev.thumb.trapfatal", "true");
+  setInternal("dev.thumb.trapoverrun", "false");
   setInternal("dev.eepromaccess", "true");
 }
 
@@ -337,6 +346,9 @@ void Settings::validate()
   i = getInt("dev.tm.uncompressed");
   if(i < 0 || i > size) setInternal("dev.tm.uncompressed", size);
 
+  i = getInt("dev.tm.memory");
+  if(i < 16 || i > 1024) setInternal("dev.tm.memory", 256);
+
   /*i = getInt("dev.tm.interval");
   if(i < 0 || i > 5) setInternal("dev.tm.interval", 0);
 
@@ -356,6 +368,9 @@ void Settings::validate()
   i = getInt("plr.tm.uncompressed");
   if(i < 0 || i > size) setInternal("plr.tm.uncompressed", size);
 
+  i = getInt("plr.tm.memory");
+  if(i < 16 || i > 1024) setInternal("plr.tm.memory", 256);
+
   /*i = getInt("plr.tm.interval");
   if(i < 0 || i > 5) setInternal("plr.tm.interval", 3);
 
@@ -446,7 +461,7 @@ void Settings::usage() const
     << "  -audio.volume             <number>     Vokume (0-100)\n"
     << "  -audio.stereo             <byrom|mono| Enable stereo mode\n"
     << "                            stereo>\n"
-    << "  -audio.preset             <1-5>        Audio preset (or 1 for custom)\n"
+    << "  -audio.preset             <1-6>        Audio preset (or 1 for custom)\n"
     << "  -audio.sample_rate        <number>     Output sample rate (44100|48000|96000)\n"
     << "  -audio.fragment_size      <number>     Fragment size (128|256|512|1024|\n"
     << "                                          2048|4096)\n"
@@ -454,7 +469,11 @@ void Settings::usage() const
     << "                                         frames to buffer(0-20)\n"
     << "  -audio.headroom           <number>     Additional half-frames to prebuffer\n"
     << "                                          (0-20)\n"
-    << "  -audio.resampling_quality <1-3>        Resampling quality\n"
+    << "  -audio.resampling_quality <1-4>        Resampling quality\n"
+    << "  -audio.dynamic_rate       <1|0>        Adjust the resampling rate to keep\n"
+    << "                                          the audio queue short\n"
+    << "  -audio.stats              <seconds>    Log audio pipeline statistics in\n"
+    << "                                          this interval (0 for off)\n"
     << endl
   #endif
     << "  -tia.zoom      <zoom>         Use the specified zoom level (windowed mode)\n"
@@ -516,6 +535,8 @@ void Settings::usage() const
     << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
     << "  -threads      <1|0>          Whether to using multi-threading during\n"
     << "                                emulation\n"
+    << "  -armthread    <1|0>          Run ARM code of DPC+/CDF/BUS ROMs in a separate\n"
+    << "                                thread\n"
     << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
     << "  -snaploaddir  <path>         The directory to load snapshot files from\n"
     << "  -snapname     <int|rom>      Name snapshots according to internal database or\n"
@@ -529,6 +550,9 @@ void Settings::usage() const
     << "  -rominfo      <rom>          Display detailed information for the given ROM\n"
     << "  -listrominfo                 Display contents of stella.pro, one line per ROM\n"
     << "                                entry\n"
+    << "  -renderaudio  <file>         Render the audio of the given ROM to a WAV file\n"
+    << "                                (as fast as possible), and then exit\n"
+    << "  -rendertime   <seconds>      Emulated time to render with -renderaudio\n"
     << "                               \n"
     << "  -exitlauncher <1|0>          On exiting a ROM, go back to the ROM launcher\n"
     << "  -launcherres  <WxH>          The resolution to use in ROM launcher mode\n"
@@ -623,6 +647,8 @@ void Settings::usage() const
     << "                                    read/peek\n"
     << "  -plr.thumb.trapfatal <1|0>       Determines whether errors in ARM emulation\n"
     << "                                    throw an exception\n"
+    << "  -plr.thumb.trapoverrun <1|0>     Determines whether ARM code taking too long\n"
+    << "                                    enters the debugger\n"
     << "  -plr.eepromaccess <1|0>          Enable messages for AtariVox/SaveKey access\n"
     << "                                    messages\n"
     << endl
@@ -642,6 +668,8 @@ void Settings::usage() const
     << "                                    read/peek\n"
     << "  -dev.thumb.trapfatal <1|0>       Determines whether errors in ARM emulation\n"
     << "                                    throw an exception\n"
+    << "  -dev.thumb.trapoverrun <1|0>     Determines whether ARM code taking too long\n"
+    << "                                    enters the debugger\n"
     << "  -dev.eepromaccess <1|0>          Enable messages for AtariVox/SaveKey access\n"
     << "                                    messages\n"
     << endl << std::flush;
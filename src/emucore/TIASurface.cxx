@@ -56,8 +56,8 @@ TIASurface::TIASurface(OSystem& system)
 
   memset(myRGBFramebuffer, 0, sizeof(myRGBFramebuffer));
 
-  // Enable/disable threading in the NTSC TV effects renderer
-  myNTSCFilter.enableThreading(myOSystem.settings().getBool("threads"));
+  // The NTSC TV effects renderer uses the threads of the system (if enabled)
+  myNTSCFilter.setThreadPool(&myOSystem.threadPool());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
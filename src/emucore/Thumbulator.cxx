@@ -44,6 +44,10 @@ using Common::Base;
   #define DO_DBUG(statement)
 #endif
 
+// Flash wait states of the LPC2103 at 70 MHz (MAMTIM), paid whenever an
+// access isn't served by the MAM buffers
+static constexpr uInt32 FLASH_CYCLES = 4;
+
 #ifdef __BIG_ENDIAN__
   #define CONV_DATA(d)   (((d & 0xFFFF)>>8) | ((d & 0xffff)<<8)) & 0xffff;
   #define CONV_RAMROM(d) ((d>>8) | (d<<8)) & 0xffff;
@@ -57,6 +61,7 @@ Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, bool traponfata
                          Thumbulator::ConfigureFor configurefor, Cartridge* cartridge)
   : rom(rom_ptr),
     ram(ram_ptr),
+    mamcr(0),
     T1TCR(0),
     T1TC(0),
     configuration(configurefor),
@@ -107,6 +112,14 @@ void Thumbulator::updateTimer(uInt32 cycles)
     T1TC += uInt32(cycles * timing_factor);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::resetPeripherals()
+{
+  // The MAM mode is set up once by the driver, and stays in effect for
+  // all following calls into the ARM code
+  mamcr = 0;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Thumbulator::run(uInt32 cycles)
 {
@@ -169,10 +182,18 @@ uInt32 Thumbulator::fetch16(uInt32 addr)
 {
   ++fetches;
 
+  // A non-sequential fetch (branch, BL, BX, POP {PC}, ...) refills the
+  // pipeline, which costs two more cycles
+  bool sequential = addr == last_fetch + 2;
+  if(!sequential)
+    arm_cycles += 2;
+  last_fetch = addr;
+
   uInt32 data;
   switch(addr & 0xF0000000)
   {
     case 0x00000000: //ROM
+      arm_cycles += flashCycles(addr, true, sequential);
       addr &= ROMADDMASK;
       if(addr < 0x50)
         fatalError("fetch16", addr, "abort");
@@ -183,6 +204,7 @@ uInt32 Thumbulator::fetch16(uInt32 addr)
       return data;
 
     case 0x40000000: //RAM
+      ++arm_cycles;
       addr &= RAMADDMASK;
       addr >>= 1;
       data=CONV_RAMROM(ram[addr]);
@@ -219,7 +241,34 @@ uInt32 Thumbulator::fetch32(uInt32 addr)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::write16(uInt32 addr, uInt32 data)
+uInt32 Thumbulator::flashCycles(uInt32 addr, bool fetch, bool sequential)
+{
+  // The MAM holds one 128-bit flash line each for instructions and data,
+  // and prefetches the next line for sequential instruction fetches
+  uInt32 line = addr >> 4;
+  uInt32& buffered = fetch ? mam_fetch_line : mam_data_line;
+  bool hit = false;
+
+  switch(mamcr)
+  {
+    case 1:  // partially enabled: sequential fetches only
+      hit = fetch && sequential;
+      break;
+
+    case 2:  // fully enabled
+      hit = (line == buffered) || (fetch && sequential);
+      break;
+
+    default: // disabled
+      break;
+  }
+  buffered = line;
+
+  return hit ? 1 : FLASH_CYCLES;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::write16(uInt32 addr, uInt32 data, bool timed)
 {
   if((addr > 0x40001fff) && (addr < 0x50000000))
     fatalError("write16", addr, "abort - out of range");
@@ -230,6 +279,8 @@ void Thumbulator::write16(uInt32 addr, uInt32 data)
     fatalError("write16", addr, "abort - misaligned");
 
   ++writes;
+  if(timed)
+    ++arm_cycles;
 
   DO_DBUG(statusMsg << "write16(" << Base::HEX8 << addr << "," << Base::HEX8 << data << ")" << endl);
 
@@ -261,6 +312,9 @@ void Thumbulator::write32(uInt32 addr, uInt32 data)
   if (isProtected(addr)) fatalError("write32", addr, "to driver area");
   DO_DBUG(statusMsg << "write32(" << Base::HEX8 << addr << "," << Base::HEX8 << data << ")" << endl);
 
+  // RAM and peripherals are 32 bits wide
+  ++arm_cycles;
+
   switch(addr & 0xF0000000)
   {
     case 0xF0000000: //halt
@@ -327,8 +381,8 @@ void Thumbulator::write32(uInt32 addr, uInt32 data)
       return;
 
     case 0x40000000: //RAM
-      write16(addr+0, (data >>  0) & 0xFFFF);
-      write16(addr+2, (data >> 16) & 0xFFFF);
+      write16(addr+0, (data >>  0) & 0xFFFF, false);
+      write16(addr+2, (data >> 16) & 0xFFFF, false);
       return;
   }
   fatalError("write32", addr, data, "abort");
@@ -358,7 +412,7 @@ bool Thumbulator::isProtected(uInt32 addr)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Thumbulator::read16(uInt32 addr)
+uInt32 Thumbulator::read16(uInt32 addr, bool timed)
 {
   uInt32 data;
 
@@ -371,6 +425,10 @@ uInt32 Thumbulator::read16(uInt32 addr)
 
   ++reads;
 
+  // Loads take one internal cycle besides the memory access
+  if(timed)
+    arm_cycles += ((addr & 0xF0000000) ? 1 : flashCycles(addr, false, false)) + 1;
+
   switch(addr & 0xF0000000)
   {
     case 0x00000000: //ROM
@@ -408,13 +466,15 @@ uInt32 Thumbulator::read32(uInt32 addr)
   {
     case 0x00000000: //ROM
     case 0x40000000: //RAM
-      data = read16(addr+0);
-      data |= (uInt32(read16(addr+2))) << 16;
+      arm_cycles += ((addr & 0xF0000000) ? 1 : flashCycles(addr, false, false)) + 1;
+      data = read16(addr+0, false);
+      data |= (uInt32(read16(addr+2, false))) << 16;
       DO_DBUG(statusMsg << "read32(" << Base::HEX8 << addr << ")=" << Base::HEX8 << data << endl);
       return data;
 
     case 0xE0000000:
     {
+      arm_cycles += 2;
       switch(addr)
       {
         case 0xE0008004:  // T1TCR - Timer 1 Control Register
@@ -1763,6 +1823,12 @@ int Thumbulator::execute()
     write_register(rd, rc);
     do_nflag(rc);
     do_zflag(rc);
+    // Early termination of the multiplier, based on the significant
+    // bytes of the multiplier operand
+    if((ra & 0xFFFFFF00) == 0 || (ra & 0xFFFFFF00) == 0xFFFFFF00)      arm_cycles += 1;
+    else if((ra & 0xFFFF0000) == 0 || (ra & 0xFFFF0000) == 0xFFFF0000) arm_cycles += 2;
+    else if((ra & 0xFF000000) == 0 || (ra & 0xFF000000) == 0xFF000000) arm_cycles += 3;
+    else                                                               arm_cycles += 4;
     return 0;
   }
 
@@ -2341,7 +2407,7 @@ int Thumbulator::reset()
       break;
   }
 
-  cpsr = mamcr = 0;
+  cpsr = 0;
   handler_mode = false;
 
   systick_ctrl = 0x00000004;
@@ -2352,6 +2418,9 @@ int Thumbulator::reset()
   // fxq: don't care about below so much (maybe to guess timing???)
   instructions = fetches = reads = writes = systick_ints = 0;
 
+  arm_cycles = 0;
+  last_fetch = mam_fetch_line = mam_data_line = 0xFFFFFFFF;
+
   statusMsg.str("");
 
   return 0;
@@ -95,18 +95,47 @@ class Thumbulator
     */
     void setConsoleTiming(ConsoleTiming timing);
 
+    /**
+      Reset the on-chip peripherals which keep their setup between calls
+      to run() (the Memory Accelerator Module), as on a cartridge reset.
+    */
+    void resetPeripherals();
+
+    /**
+      The MAM control register, which is part of the cartridge state since
+      it persists between calls to run() and affects the cycle estimate.
+    */
+    uInt32 mamMode() const { return mamcr; }
+    void setMamMode(uInt32 mode) { mamcr = mode; }
+
+    /**
+      Estimated number of ARM cycles the last call to run() takes on the
+      real hardware (LPC2103 at 70 MHz).  The estimate accounts for the
+      instruction mix (pipeline refills, multiplies, loads/stores), and
+      for flash accesses depending on the MAM mode set by the driver.
+    */
+    uInt64 cycles() const { return arm_cycles; }
+
+    /**
+      The same estimate, converted to 6507 cycles for the current console.
+    */
+    uInt32 cycles6507() const { return uInt32(arm_cycles / timing_factor); }
+
   private:
     uInt32 read_register(uInt32 reg);
     void write_register(uInt32 reg, uInt32 data);
     uInt32 fetch16(uInt32 addr);
     uInt32 fetch32(uInt32 addr);
-    uInt32 read16(uInt32 addr);
+    uInt32 read16(uInt32 addr, bool timed = true);
     uInt32 read32(uInt32 addr);
     bool isProtected(uInt32 addr);
-    void write16(uInt32 addr, uInt32 data);
+    void write16(uInt32 addr, uInt32 data, bool timed = true);
     void write32(uInt32 addr, uInt32 data);
     void updateTimer(uInt32 cycles);
 
+    // Cycles of a flash access, as served by the Memory Accelerator Module
+    uInt32 flashCycles(uInt32 addr, bool fetch, bool sequential);
+
     void do_zflag(uInt32 x);
     void do_nflag(uInt32 x);
     void do_cflag(uInt32 a, uInt32 b, uInt32 c);
@@ -135,6 +164,11 @@ class Thumbulator
     uInt32 systick_ctrl, systick_reload, systick_count, systick_calibrate;
     uInt64 instructions, fetches, reads, writes, systick_ints;
 
+    // Cycle estimate of the current call (see cycles()), the address of
+    // the last instruction fetch, and the flash lines in the MAM buffers
+    uInt64 arm_cycles;
+    uInt32 last_fetch, mam_fetch_line, mam_data_line;
+
     // For emulation of LPC2103's timer 1, used for NTSC/PAL/SECAM detection.
     // Register names from documentation:
     // http://www.nxp.com/documents/user_manual/UM10161.pdf
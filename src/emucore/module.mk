@@ -2,6 +2,7 @@ MODULE := src/emucore
 
 MODULE_OBJS := \
 	src/emucore/AtariVox.o \
+	src/emucore/AudioRenderer.o \
 	src/emucore/Bankswitch.o \
 	src/emucore/Booster.o \
 	src/emucore/Cart.o \
@@ -15,6 +16,7 @@ MODULE_OBJS := \
 	src/emucore/Cart4K.o \
 	src/emucore/Cart4KSC.o \
 	src/emucore/CartAR.o \
+	src/emucore/CartARM.o \
 	src/emucore/CartBUS.o \
 	src/emucore/CartCDF.o \
 	src/emucore/CartCM.o \
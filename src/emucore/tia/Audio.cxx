@@ -36,6 +36,7 @@ namespace {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Audio::Audio()
   : myAudioQueue(nullptr),
+    myOutputEnabled(true),
     myCurrentFragment(nullptr)
 {
   for (uInt8 i = 0; i <= 0x1e; ++i) myMixingTableSum[i] = mixingTableEntry(i, 0x1e);
@@ -63,6 +64,19 @@ void Audio::setAudioQueue(shared_ptr<AudioQueue> queue)
   mySampleIndex = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Audio::flush()
+{
+  const uInt32 samples = mySampleIndex;
+
+  if (!myAudioQueue || samples == 0) return 0;
+
+  mySampleIndex = 0;
+  myCurrentFragment = myAudioQueue->enqueue(myCurrentFragment);
+
+  return samples;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Audio::tick()
 {
@@ -89,7 +103,7 @@ void Audio::phase1()
   uInt8 sample0 = myChannel0.phase1();
   uInt8 sample1 = myChannel1.phase1();
 
-  if (!myAudioQueue) return;
+  if (!myAudioQueue || !myOutputEnabled) return;
 
   if (myAudioQueue->isStereo()) {
     myCurrentFragment[2*mySampleIndex] = myMixingTableIndividual[sample0];
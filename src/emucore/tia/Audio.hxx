@@ -33,6 +33,16 @@ class Audio : public Serializable
 
     void setAudioQueue(shared_ptr<AudioQueue> queue);
 
+    void setOutputEnabled(bool enabled) { myOutputEnabled = enabled; }
+
+    /**
+      Send the partly filled current fragment to the queue.
+
+      @return  The number of samples in that fragment (0 if it was empty,
+               and hence not sent)
+    */
+    uInt32 flush();
+
     void tick();
 
     AudioChannel& channel0();
@@ -50,6 +60,7 @@ class Audio : public Serializable
 
   private:
     shared_ptr<AudioQueue> myAudioQueue;
+    bool myOutputEnabled;
 
     uInt8 myCounter;
 
@@ -17,6 +17,122 @@
 
 #include "AudioChannel.hxx"
 
+namespace {
+  // The flags latched in phase 0
+  constexpr uInt8 NOISE_FEEDBACK = 0x01;
+  constexpr uInt8 NOISE_COUNTER_BIT4 = 0x02;
+  constexpr uInt8 PULSE_COUNTER_HOLD = 0x04;
+
+  constexpr uInt16 POLY_STATES = 0x200;
+
+  /**
+    The polynomial counter logic, evaluated once for all combinations of
+    AUDC and counter state.
+  */
+  class PolyTables
+  {
+    public:
+      PolyTables()
+      {
+        for (uInt8 audc = 0; audc < 0x10; ++audc) {
+          for (uInt16 state = 0; state < POLY_STATES; ++state)
+            myClockFlags[audc][state] = clockFlags(audc, state >> 4, state & 0x0f);
+
+          for (uInt8 flags = 0; flags < 8; ++flags)
+            for (uInt8 pulse = 0; pulse < 0x10; ++pulse)
+              myPulseCounter[audc][flags][pulse] = nextPulseCounter(audc, flags, pulse);
+        }
+      }
+
+      uInt8 clockFlags(uInt8 audc, uInt16 state) const {
+        return myClockFlags[audc][state];
+      }
+
+      uInt16 nextState(uInt8 audc, uInt8 flags, uInt16 state) const {
+        return
+          ((state >> 1) & 0xf0) |
+          ((flags & NOISE_FEEDBACK) ? 0x100 : 0) |
+          myPulseCounter[audc][flags][state & 0x0f];
+      }
+
+    private:
+      static uInt8 clockFlags(uInt8 audc, uInt8 noiseCounter, uInt8 pulseCounter)
+      {
+        uInt8 flags = 0;
+
+        if (noiseCounter & 0x01) flags |= NOISE_COUNTER_BIT4;
+
+        switch (audc & 0x03) {
+          case 0x02:
+            if ((noiseCounter & 0x1e) != 0x02) flags |= PULSE_COUNTER_HOLD;
+            break;
+
+          case 0x03:
+            if (!(noiseCounter & 0x01)) flags |= PULSE_COUNTER_HOLD;
+            break;
+        }
+
+        bool noiseFeedback;
+        switch (audc & 0x03) {
+          case 0x00:
+            noiseFeedback =
+              ((pulseCounter ^ noiseCounter) & 0x01) ||
+              !(noiseCounter || (pulseCounter != 0x0a)) ||
+              !(audc & 0x0c);
+
+            break;
+
+          default:
+            noiseFeedback =
+              (((noiseCounter & 0x04) ? 1 : 0) ^ (noiseCounter & 0x01)) ||
+              noiseCounter == 0;
+
+            break;
+        }
+
+        if (noiseFeedback) flags |= NOISE_FEEDBACK;
+
+        return flags;
+      }
+
+      static uInt8 nextPulseCounter(uInt8 audc, uInt8 flags, uInt8 pulseCounter)
+      {
+        if (flags & PULSE_COUNTER_HOLD) return pulseCounter;
+
+        bool pulseFeedback = false;
+        switch (audc >> 2) {
+          case 0x00:
+            pulseFeedback =
+              (((pulseCounter & 0x02) ? 1 : 0) ^ (pulseCounter & 0x01)) &&
+              (pulseCounter != 0x0a) &&
+              (audc & 0x03);
+
+            break;
+
+          case 0x01:
+            pulseFeedback = !(pulseCounter & 0x08);
+            break;
+
+          case 0x02:
+            pulseFeedback = !(flags & NOISE_COUNTER_BIT4);
+            break;
+
+          case 0x03:
+            pulseFeedback = !((pulseCounter & 0x02) || !(pulseCounter & 0x0e));
+            break;
+        }
+
+        return (~(pulseCounter >> 1) & 0x07) | (pulseFeedback ? 0x08 : 0);
+      }
+
+    private:
+      uInt8 myClockFlags[0x10][POLY_STATES];
+      uInt8 myPulseCounter[0x10][8][0x10];
+  };
+
+  const PolyTables polyTables;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioChannel::AudioChannel()
 {
@@ -27,48 +143,16 @@ AudioChannel::AudioChannel()
 void AudioChannel::reset()
 {
   myAudc = myAudv = myAudf = 0;
-  myClockEnable = myNoiseFeedback = myNoiseCounterBit4 = myPulseCounterHold = false;
-  myDivCounter = myPulseCounter = myNoiseCounter = 0;
+  myClockEnable = false;
+  myClockFlags = 0;
+  myDivCounter = 0;
+  myPolyState = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioChannel::phase0()
 {
-  if (myClockEnable) {
-    myNoiseCounterBit4 = myNoiseCounter & 0x01;
-
-    switch (myAudc & 0x03) {
-      case 0x00:
-      case 0x01:
-        myPulseCounterHold = false;
-        break;
-
-      case 0x02:
-        myPulseCounterHold = (myNoiseCounter & 0x1e) != 0x02;
-        break;
-
-      case 0x03:
-        myPulseCounterHold = !myNoiseCounterBit4;
-        break;
-    }
-
-    switch (myAudc & 0x03) {
-      case 0x00:
-        myNoiseFeedback =
-          ((myPulseCounter ^ myNoiseCounter) & 0x01) ||
-          !(myNoiseCounter || (myPulseCounter != 0x0a)) ||
-          !(myAudc & 0x0c);
-
-        break;
-
-      default:
-        myNoiseFeedback =
-          (((myNoiseCounter & 0x04) ? 1 : 0) ^ (myNoiseCounter & 0x01)) ||
-          myNoiseCounter == 0;
-
-      break;
-    }
-  }
+  if (myClockEnable) myClockFlags = polyTables.clockFlags(myAudc, myPolyState);
 
   myClockEnable = myDivCounter == myAudf;
 
@@ -82,45 +166,9 @@ void AudioChannel::phase0()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 AudioChannel::phase1()
 {
-  if (myClockEnable) {
-    bool pulseFeedback = false;
-    switch (myAudc >> 2) {
-      case 0x00:
-        pulseFeedback =
-          (((myPulseCounter & 0x02) ? 1 : 0) ^ (myPulseCounter & 0x01)) &&
-          (myPulseCounter != 0x0a) &&
-          (myAudc & 0x03);
-
-        break;
-
-      case 0x01:
-        pulseFeedback = !(myPulseCounter & 0x08);
-        break;
-
-      case 0x02:
-        pulseFeedback = !myNoiseCounterBit4;
-        break;
-
-      case 0x03:
-        pulseFeedback = !((myPulseCounter & 0x02) || !(myPulseCounter & 0x0e));
-        break;
-    }
-
-    myNoiseCounter >>= 1;
-    if (myNoiseFeedback) {
-      myNoiseCounter |= 0x10;
-    }
-
-    if (!myPulseCounterHold) {
-      myPulseCounter = ~(myPulseCounter >> 1) & 0x07;
-
-      if (pulseFeedback) {
-        myPulseCounter |= 0x08;
-      }
-    }
-  }
+  if (myClockEnable) myPolyState = polyTables.nextState(myAudc, myClockFlags, myPolyState);
 
-  return (myPulseCounter & 0x01) * myAudv;
+  return (myPolyState & 0x01) * myAudv;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -151,13 +199,13 @@ bool AudioChannel::save(Serializer& out) const
     out.putInt(myAudf);
 
     out.putBool(myClockEnable);
-    out.putBool(myNoiseFeedback);
-    out.putBool(myNoiseCounterBit4);
-    out.putBool(myPulseCounterHold);
+    out.putBool(myClockFlags & NOISE_FEEDBACK);
+    out.putBool(myClockFlags & NOISE_COUNTER_BIT4);
+    out.putBool(myClockFlags & PULSE_COUNTER_HOLD);
 
     out.putInt(myDivCounter);
-    out.putInt(myPulseCounter);
-    out.putInt(myNoiseCounter);
+    out.putInt(myPolyState & 0x0f);
+    out.putInt(myPolyState >> 4);
   }
   catch(...)
   {
@@ -178,13 +226,15 @@ bool AudioChannel::load(Serializer& in)
     myAudf = in.getInt();
 
     myClockEnable = in.getBool();
-    myNoiseFeedback = in.getBool();
-    myNoiseCounterBit4 = in.getBool();
-    myPulseCounterHold = in.getBool();
+    myClockFlags = 0;
+    if (in.getBool()) myClockFlags |= NOISE_FEEDBACK;
+    if (in.getBool()) myClockFlags |= NOISE_COUNTER_BIT4;
+    if (in.getBool()) myClockFlags |= PULSE_COUNTER_HOLD;
 
     myDivCounter = in.getInt();
-    myPulseCounter = in.getInt();
-    myNoiseCounter = in.getInt();
+    const uInt8 pulseCounter = in.getInt() & 0x0f;
+    const uInt8 noiseCounter = in.getInt() & 0x1f;
+    myPolyState = (noiseCounter << 4) | pulseCounter;
   }
   catch(...)
   {
@@ -21,6 +21,20 @@
 #include "bspf.hxx"
 #include "Serializable.hxx"
 
+/**
+  One of the two TIA audio channels.
+
+  The channel output is driven by a 4-bit "pulse" and a 5-bit "noise"
+  polynomial counter, which are clocked by the AUDF frequency divider.  The
+  feedback logic of these counters only depends on AUDC and the counters
+  themselves, so it is precomputed into tables once, indexed by AUDC and the
+  combined 9-bit counter state.  Clocking the channel then amounts to two
+  table lookups instead of evaluating the logic bit by bit.
+
+  As the table index is the counter state itself, register writes take
+  effect at exactly the same point as on the real hardware, and the
+  counters continue from where they were.
+*/
 class AudioChannel : public Serializable
 {
   public:
@@ -50,13 +64,15 @@ class AudioChannel : public Serializable
     uInt8 myAudf;
 
     bool myClockEnable;
-    bool myNoiseFeedback;
-    bool myNoiseCounterBit4;
-    bool myPulseCounterHold;
+
+    // Feedback and hold flags, latched in phase 0 and applied in phase 1
+    // (see the flag constants in AudioChannel.cxx)
+    uInt8 myClockFlags;
 
     uInt8 myDivCounter;
-    uInt8 myPulseCounter;
-    uInt8 myNoiseCounter;
+
+    // The counter state: noise counter in bits 4-8, pulse counter in 0-3
+    uInt16 myPolyState;
 
   private:
     AudioChannel(const AudioChannel&);
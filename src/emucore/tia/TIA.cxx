@@ -784,9 +784,14 @@ bool TIA::saveDisplay(Serializer& out) const
 {
   try
   {
-    out.putByteArray(myFramebuffer, 160* TIAConstants::frameBufferHeight);
-    out.putByteArray(myBackBuffer, 160 * TIAConstants::frameBufferHeight);
+    // The last completed frame, and the part of the current frame drawn
+    // so far (including the current scanline); the back buffer below that
+    // still equals the front buffer, see onFrameComplete()
+    const uInt32 lines = std::min(myFrameManager->getY() + 1, TIAConstants::frameBufferHeight);
+
     out.putByteArray(myFrontBuffer, 160 * TIAConstants::frameBufferHeight);
+    out.putInt(lines);
+    out.putByteArray(myBackBuffer, 160 * lines);
     out.putInt(myFramesSinceLastRender);
   }
   catch(...)
@@ -804,10 +809,18 @@ bool TIA::loadDisplay(Serializer& in)
   try
   {
     // Reset frame buffer pointer and data
-    in.getByteArray(myFramebuffer, 160 * TIAConstants::frameBufferHeight);
-    in.getByteArray(myBackBuffer, 160 * TIAConstants::frameBufferHeight);
     in.getByteArray(myFrontBuffer, 160 * TIAConstants::frameBufferHeight);
+    const uInt32 lines = in.getInt();
+    if(lines > TIAConstants::frameBufferHeight)
+      throw runtime_error("invalid number of scanlines");
+
+    memcpy(myBackBuffer, myFrontBuffer, 160 * TIAConstants::frameBufferHeight);
+    in.getByteArray(myBackBuffer, 160 * lines);
     myFramesSinceLastRender = in.getInt();
+
+    // Show the last completed frame, even if the state was taken mid-frame
+    memcpy(myFramebuffer, myFrontBuffer, 160 * TIAConstants::frameBufferHeight);
+    myFrameBufferScanlines = myFrontBufferScanlines;
   }
   catch(...)
   {
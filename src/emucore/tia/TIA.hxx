@@ -126,6 +126,20 @@ class TIA : public Device
     */
     void setAudioQueue(shared_ptr<AudioQueue> audioQueue);
 
+    /**
+      Enable/disable sending the generated audio to the audio queue (the
+      audio is still emulated).  Used when replaying emulation quickly.
+    */
+    void setAudioOutputEnabled(bool enabled) { myAudio.setOutputEnabled(enabled); }
+
+    /**
+      Send the partly filled last fragment of audio to the audio queue (the
+      rest of the fragment is undefined).  Used when rendering audio ends.
+
+      @return  The number of samples in that fragment (0 if there was none)
+    */
+    uInt32 flushAudio() { return myAudio.flush(); }
+
     /**
       Clear the configured frame manager and deteach the lifecycle callbacks.
      */
@@ -195,6 +209,12 @@ class TIA : public Device
       the debugger state save has 'cycle resolution', and hence needs
       more information.  The methods below save/load this extra info,
       and eliminate having to save approx. 50K to normal state files.
+
+      Only the last completed frame (the front buffer) and the scanlines
+      drawn so far of the current frame are saved; the rest of the back
+      buffer and the framebuffer are recreated from the front buffer when
+      loading.  This keeps the Time Machine states smaller, while showing
+      the same frame as before.
     */
     bool saveDisplay(Serializer& out) const;
     bool loadDisplay(Serializer& in);
@@ -53,7 +53,7 @@ AudioDialog::AudioDialog(OSystem& osystem, DialogContainer& parent,
 
   // Set real dimensions
   _w = 46 * fontWidth + HBORDER * 2;
-  _h = 11 * (lineHeight + VGAP) + VBORDER + _th;
+  _h = 12 * (lineHeight + VGAP) + VBORDER + _th;
 
   xpos = HBORDER;  ypos = VBORDER + _th;
 
@@ -90,6 +90,7 @@ AudioDialog::AudioDialog(OSystem& osystem, DialogContainer& parent,
   VarList::push_back(items, "High quality, medium lag", static_cast<int>(AudioSettings::Preset::highQualityMediumLag));
   VarList::push_back(items, "High quality, low lag", static_cast<int>(AudioSettings::Preset::highQualityLowLag));
   VarList::push_back(items, "Ultra quality, minimal lag", static_cast<int>(AudioSettings::Preset::veryHighQualityVeryLowLag));
+  VarList::push_back(items, "Low latency, dynamic rate", static_cast<int>(AudioSettings::Preset::lowLatency));
   VarList::push_back(items, "Custom", static_cast<int>(AudioSettings::Preset::custom));
   myModePopup = new PopUpWidget(this, font, xpos, ypos,
                                    font.getStringWidth("Ultry quality, minimal lag"), lineHeight,
@@ -130,6 +131,7 @@ AudioDialog::AudioDialog(OSystem& osystem, DialogContainer& parent,
   VarList::push_back(items, "Low", static_cast<int>(AudioSettings::ResamplingQuality::nearestNeightbour));
   VarList::push_back(items, "High", static_cast<int>(AudioSettings::ResamplingQuality::lanczos_2));
   VarList::push_back(items, "Ultra", static_cast<int>(AudioSettings::ResamplingQuality::lanczos_3));
+  VarList::push_back(items, "BLEP", static_cast<int>(AudioSettings::ResamplingQuality::blep));
   myResamplingPopup = new PopUpWidget(this, font, xpos, ypos,
                                 pwidth, lineHeight,
                                 items, "Resampling quality ", lwidth);
@@ -151,6 +153,12 @@ AudioDialog::AudioDialog(OSystem& osystem, DialogContainer& parent,
   myBufferSizeSlider->setMinValue(0); myBufferSizeSlider->setMaxValue(AudioSettings::MAX_BUFFER_SIZE);
   myBufferSizeSlider->setTickmarkInterval(5);
   wid.push_back(myBufferSizeSlider);
+  ypos += lineHeight + VGAP;
+
+  // Dynamic rate control
+  myDynamicRateCheckbox = new CheckboxWidget(this, font, xpos, ypos,
+                                             "Dynamic rate control");
+  wid.push_back(myDynamicRateCheckbox);
 
   // Add Defaults, OK and Cancel buttons
   addDefaultsOKCancelBGroup(wid, font);
@@ -197,6 +205,9 @@ void AudioDialog::updateSettingsWithPreset(AudioSettings& audioSettings)
 
   // Resampling quality
   myResamplingPopup->setSelected(static_cast<int>(audioSettings.resamplingQuality()));
+
+  // Dynamic rate control
+  myDynamicRateCheckbox->setState(audioSettings.dynamicRate());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -225,6 +236,7 @@ void AudioDialog::saveConfig()
     audioSettings.setHeadroom(myHeadroomSlider->getValue());
     audioSettings.setBufferSize(myBufferSizeSlider->getValue());
     audioSettings.setResamplingQuality(static_cast<AudioSettings::ResamplingQuality>(myResamplingPopup->getSelectedTag().toInt()));
+    audioSettings.setDynamicRate(myDynamicRateCheckbox->getState());
   }
 
   // Only force a re-initialization when necessary, since it can
@@ -247,6 +259,7 @@ void AudioDialog::setDefaults()
     myFreqPopup->setSelected(AudioSettings::DEFAULT_SAMPLE_RATE);
     myHeadroomSlider->setValue(AudioSettings::DEFAULT_HEADROOM);
     myBufferSizeSlider->setValue(AudioSettings::DEFAULT_BUFFER_SIZE);
+    myDynamicRateCheckbox->setState(AudioSettings::DEFAULT_DYNAMIC_RATE);
   }
   else updatePreset();
 
@@ -269,6 +282,7 @@ void AudioDialog::updateEnabledState()
   myResamplingPopup->setEnabled(active && userMode);
   myHeadroomSlider->setEnabled(active && userMode);
   myBufferSizeSlider->setEnabled(active && userMode);
+  myDynamicRateCheckbox->setEnabled(active && userMode);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
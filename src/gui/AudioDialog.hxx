@@ -62,6 +62,7 @@ class AudioDialog : public Dialog
     PopUpWidget*      myResamplingPopup;
     SliderWidget*     myHeadroomSlider;
     SliderWidget*     myBufferSizeSlider;
+    CheckboxWidget*   myDynamicRateCheckbox;
     PopUpWidget*      myStereoSoundPopup;
 
   private:
@@ -157,6 +157,12 @@ void DeveloperDialog::addEmulationTab(const GUI::Font& font)
   wid.push_back(myThumbExceptionWidget);
   ypos += lineHeight + VGAP;
 
+  // Thumb ARM emulation cycle overrun
+  myThumbOverrunWidget = new CheckboxWidget(myTab, font, HBORDER + INDENT * 1, ypos + 1,
+                                            "ARM cycle overrun enters debugger");
+  wid.push_back(myThumbOverrunWidget);
+  ypos += lineHeight + VGAP;
+
   // AtariVox/SaveKey EEPROM access
   myEEPROMAccessWidget = new CheckboxWidget(myTab, font, HBORDER + INDENT * 1, ypos + 1,
                                             "Display AtariVox/SaveKey EEPROM R/W access");
@@ -343,6 +349,15 @@ void DeveloperDialog::addTimeMachineTab(const GUI::Font& font)
   wid.push_back(myStateSizeWidget);
   ypos += lineHeight + VGAP;
 
+  myStateMemoryWidget = new SliderWidget(myTab, font, HBORDER + INDENT * 2, ypos - 1, swidth, lineHeight,
+                                         "Memory budget     ", 0, 0, lwidth, " MB");
+  myStateMemoryWidget->setMinValue(16);
+  myStateMemoryWidget->setMaxValue(1024);
+  myStateMemoryWidget->setStepValue(16);
+  myStateMemoryWidget->setTickmarkInterval(8);
+  wid.push_back(myStateMemoryWidget);
+  ypos += lineHeight + VGAP;
+
   myUncompressedWidget = new SliderWidget(myTab, font, HBORDER + INDENT * 2, ypos - 1, swidth, lineHeight,
                                           "Uncompressed size ", 0, kUncompressedChanged, lwidth, " states");
   myUncompressedWidget->setMinValue(0);
@@ -367,6 +382,11 @@ void DeveloperDialog::addTimeMachineTab(const GUI::Font& font)
   myStateHorizonWidget = new PopUpWidget(myTab, font, HBORDER + INDENT * 2, ypos, pwidth,
                                          lineHeight, items, "Horizon         ~ ", 0, kHorizonChanged);
   wid.push_back(myStateHorizonWidget);
+  ypos += lineHeight + VGAP;
+
+  myStateArchiveWidget = new CheckboxWidget(myTab, font, HBORDER + INDENT * 2, ypos + 1,
+                                            "Keep history on disk");
+  wid.push_back(myStateArchiveWidget);
 
   // Add message concerning usage
   const GUI::Font& infofont = instance().frameBuffer().infoFont();
@@ -489,6 +509,8 @@ void DeveloperDialog::loadSettings(SettingsSet set)
   myUndrivenPins[set] = instance().settings().getBool(prefix + "tiadriven");
   // Thumb ARM emulation exception
   myThumbException[set] = instance().settings().getBool(prefix + "thumb.trapfatal");
+  // Thumb ARM emulation cycle overrun
+  myThumbOverrun[set] = instance().settings().getBool(prefix + "thumb.trapoverrun");
   // AtariVox/SaveKey EEPROM access
   myEEPROMAccess[set] = instance().settings().getBool(prefix + "eepromaccess");
 
@@ -503,6 +525,8 @@ void DeveloperDialog::loadSettings(SettingsSet set)
   // States
   myTimeMachine[set] = instance().settings().getBool(prefix + "timemachine");
   myStateSize[set] = instance().settings().getInt(prefix + "tm.size");
+  myStateMemory[set] = instance().settings().getInt(prefix + "tm.memory");
+  myStateArchive[set] = instance().settings().getBool(prefix + "tm.archive");
   myUncompressed[set] = instance().settings().getInt(prefix + "tm.uncompressed");
   myStateInterval[set] = instance().settings().getString(prefix + "tm.interval");
   myStateHorizon[set] = instance().settings().getString(prefix + "tm.horizon");
@@ -523,6 +547,8 @@ void DeveloperDialog::saveSettings(SettingsSet set)
   instance().settings().setValue(prefix + "tiadriven", myUndrivenPins[set]);
   // Thumb ARM emulation exception
   instance().settings().setValue(prefix + "thumb.trapfatal", myThumbException[set]);
+  // Thumb ARM emulation cycle overrun
+  instance().settings().setValue(prefix + "thumb.trapoverrun", myThumbOverrun[set]);
   // AtariVox/SaveKey EEPROM access
   instance().settings().setValue(prefix + "eepromaccess", myEEPROMAccess[set]);
 
@@ -537,6 +563,8 @@ void DeveloperDialog::saveSettings(SettingsSet set)
   // States
   instance().settings().setValue(prefix + "timemachine", myTimeMachine[set]);
   instance().settings().setValue(prefix + "tm.size", myStateSize[set]);
+  instance().settings().setValue(prefix + "tm.memory", myStateMemory[set]);
+  instance().settings().setValue(prefix + "tm.archive", myStateArchive[set]);
   instance().settings().setValue(prefix + "tm.uncompressed", myUncompressed[set]);
   instance().settings().setValue(prefix + "tm.interval", myStateInterval[set]);
   instance().settings().setValue(prefix + "tm.horizon", myStateHorizon[set]);
@@ -560,6 +588,8 @@ void DeveloperDialog::getWidgetStates(SettingsSet set)
   myUndrivenPins[set] = myUndrivenPinsWidget->getState();
   // Thumb ARM emulation exception
   myThumbException[set] = myThumbExceptionWidget->getState();
+  // Thumb ARM emulation cycle overrun
+  myThumbOverrun[set] = myThumbOverrunWidget->getState();
   // AtariVox/SaveKey EEPROM access
   myEEPROMAccess[set] = myEEPROMAccessWidget->getState();
 
@@ -574,6 +604,8 @@ void DeveloperDialog::getWidgetStates(SettingsSet set)
   // States
   myTimeMachine[set] = myTimeMachineWidget->getState();
   myStateSize[set] = myStateSizeWidget->getValue();
+  myStateMemory[set] = myStateMemoryWidget->getValue();
+  myStateArchive[set] = myStateArchiveWidget->getState();
   myUncompressed[set] = myUncompressedWidget->getValue();
   myStateInterval[set] = myStateIntervalWidget->getSelected();
   myStateInterval[set] = myStateIntervalWidget->getSelectedTag().toString();
@@ -597,6 +629,8 @@ void DeveloperDialog::setWidgetStates(SettingsSet set)
   myUndrivenPinsWidget->setState(myUndrivenPins[set]);
   // Thumb ARM emulation exception
   myThumbExceptionWidget->setState(myThumbException[set]);
+  // Thumb ARM emulation cycle overrun
+  myThumbOverrunWidget->setState(myThumbOverrun[set]);
   // AtariVox/SaveKey EEPROM access
   myEEPROMAccessWidget->setState(myEEPROMAccess[set]);
 
@@ -616,6 +650,8 @@ void DeveloperDialog::setWidgetStates(SettingsSet set)
   // States
   myTimeMachineWidget->setState(myTimeMachine[set]);
   myStateSizeWidget->setValue(myStateSize[set]);
+  myStateMemoryWidget->setValue(myStateMemory[set]);
+  myStateArchiveWidget->setState(myStateArchive[set]);
   myUncompressedWidget->setValue(myUncompressed[set]);
   myStateIntervalWidget->setSelected(myStateInterval[set]);
   myStateHorizonWidget->setSelected(myStateHorizon[set]);
@@ -745,6 +781,8 @@ void DeveloperDialog::setDefaults()
       myUndrivenPins[set] = devSettings ? true : false;
       // Thumb ARM emulation exception
       myThumbException[set] = devSettings ? true : false;
+      // Thumb ARM emulation cycle overrun (not validated enough to trap by default)
+      myThumbOverrun[set] = false;
       // AtariVox/SaveKey EEPROM access
       myEEPROMAccess[set] = devSettings ? true : false;
 
@@ -767,6 +805,8 @@ void DeveloperDialog::setDefaults()
     case 2: // States
       myTimeMachine[set] = devSettings ? true : false;
       myStateSize[set] = 100;
+      myStateMemory[set] = 256;
+      myStateArchive[set] = false;
       myUncompressed[set] = devSettings ? 60 : 30;
       myStateInterval[set] = devSettings ? "1f" : "30f";
       myStateHorizon[set] = devSettings ? "10s" : "10m";
@@ -942,8 +982,10 @@ void DeveloperDialog::handleTimeMachine()
   bool enable = myTimeMachineWidget->getState();
 
   myStateSizeWidget->setEnabled(enable);
+  myStateMemoryWidget->setEnabled(enable);
   myUncompressedWidget->setEnabled(enable);
   myStateIntervalWidget->setEnabled(enable);
+  myStateArchiveWidget->setEnabled(enable);
 
   uInt32 size = myStateSizeWidget->getValue();
   uInt32 uncompressed = myUncompressedWidget->getValue();
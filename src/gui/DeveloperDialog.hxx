@@ -102,6 +102,7 @@ class DeveloperDialog : public Dialog
     CheckboxWidget*     myRandomizeCPUWidget[5];
     CheckboxWidget*     myUndrivenPinsWidget;
     CheckboxWidget*     myThumbExceptionWidget;
+    CheckboxWidget*     myThumbOverrunWidget;
     CheckboxWidget*     myEEPROMAccessWidget;
 
     // Video widgets
@@ -118,9 +119,11 @@ class DeveloperDialog : public Dialog
     RadioButtonGroup*   mySettingsGroup2;
     CheckboxWidget*     myTimeMachineWidget;
     SliderWidget*       myStateSizeWidget;
+    SliderWidget*       myStateMemoryWidget;
     SliderWidget*       myUncompressedWidget;
     PopUpWidget*        myStateIntervalWidget;
     PopUpWidget*        myStateHorizonWidget;
+    CheckboxWidget*     myStateArchiveWidget;
 
 #ifdef DEBUGGER_SUPPORT
     // Debugger UI widgets
@@ -144,13 +147,16 @@ class DeveloperDialog : public Dialog
     bool    myDebugColors[2];
     bool    myUndrivenPins[2];
     bool    myThumbException[2];
+    bool    myThumbOverrun[2];
     bool    myEEPROMAccess[2];
     // States sets
     bool    myTimeMachine[2];
     int     myStateSize[2];
+    int     myStateMemory[2];
     int     myUncompressed[2];
     string  myStateInterval[2];
     string  myStateHorizon[2];
+    bool    myStateArchive[2];
 
   private:
     void addEmulationTab(const GUI::Font& font);
@@ -232,9 +232,17 @@ TimeMachineDialog::TimeMachineDialog(OSystem& osystem, DialogContainer& parent,
                                        BUTTON_W, BUTTON_H, kUnwindAll);
   xpos = myUnwindAllWidget->getRight() + BUTTON_GAP * 4;
 
+  // Add memory usage (total and budget, and per second of history)
+  const int mwidth = font.getStringWidth("9999.9M/9999.9M 999.9K/s");
+  myMemoryWidget = new StaticTextWidget(this, font, myLastTimeWidget->getLeft() - BUTTON_GAP * 4 - mwidth,
+                                        ypos + 3, mwidth, font.getFontHeight(), "",
+                                        TextAlign::Right, kBGColor);
+  myMemoryWidget->setTextColor(kColorInfo);
+
   // Add message
-  myMessageWidget = new StaticTextWidget(this, font, xpos, ypos + 3, "                                             ",
-                                         TextAlign::Left, kBGColor);
+  myMessageWidget = new StaticTextWidget(this, font, xpos, ypos + 3,
+                                         std::max(myMemoryWidget->getLeft() - BUTTON_GAP * 4 - xpos, 0),
+                                         font.getFontHeight(), "", TextAlign::Left, kBGColor);
   myMessageWidget->setTextColor(kColorInfo);
 }
 
@@ -302,6 +310,10 @@ void TimeMachineDialog::handleKeyDown(StellaKey key, StellaMod mod)
         Dialog::handleKeyDown(key, mod);
     }
   }
+  else if(key == KBDK_LEFT)  // left(-shift) seeks back 1(10) frames
+    handleSeek(StellaModTest::isShift(mod) ? -10 : -1);
+  else if(key == KBDK_RIGHT)  // right(-shift) seeks forward 1(10) frames
+    handleSeek(StellaModTest::isShift(mod) ? 10 : 1);
   else if(key == KBDK_SPACE || key == KBDK_ESCAPE)
     handleCommand(nullptr, kPlay, 0, 0);
   else
@@ -383,6 +395,19 @@ string TimeMachineDialog::getTimeString(uInt64 cycles)
   return time.str();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string TimeMachineDialog::getMemoryString(uInt64 bytes)
+{
+  stringstream mem;
+  mem << std::fixed << std::setprecision(1);
+  if(bytes >= 1024 * 1024)
+    mem << bytes / (1024.0 * 1024.0) << "M";
+  else
+    mem << bytes / 1024.0 << "K";
+
+  return mem.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeMachineDialog::handleWinds(Int32 numWinds)
 {
@@ -407,6 +432,9 @@ void TimeMachineDialog::handleWinds(Int32 numWinds)
   // Update time
   myCurrentTimeWidget->setLabel(getTimeString(r.getCurrentCycles() - r.getFirstCycles()));
   myLastTimeWidget->setLabel(getTimeString(r.getLastCycles() - r.getFirstCycles()));
+  myMemoryWidget->setLabel(getMemoryString(r.getMemoryUsed()) + "/" +
+                           getMemoryString(r.getMemoryBudget()) + " " +
+                           getMemoryString(r.getMemoryPerSecond()) + "/s");
   myTimeline->setValue(r.getCurrentIdx()-1);
   // Update index
   myCurrentIdxWidget->setValue(r.getCurrentIdx());
@@ -418,6 +446,21 @@ void TimeMachineDialog::handleWinds(Int32 numWinds)
   myUnwind1Widget->setEnabled(!r.atLast());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimeMachineDialog::handleSeek(Int32 numFrames)
+{
+  RewindManager& r = instance().state().rewindManager();
+  Int64 startCycles = instance().console().tia().cycles();
+
+  if(r.seekFrames(numFrames))
+  {
+    Int64 elapsed = Int64(instance().console().tia().cycles()) - startCycles;
+    if(elapsed != 0)
+      myMessageWidget->setLabel((elapsed < 0 ? "(-" : "(+") + r.getUnitString(elapsed) + ")");
+  }
+  handleWinds();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeMachineDialog::handleToggle()
 {
@@ -45,8 +45,12 @@ class TimeMachineDialog : public Dialog
 
     /** convert cycles into time */
     string getTimeString(uInt64 cycles);
+    /** convert bytes into a short memory size */
+    string getMemoryString(uInt64 bytes);
     /** re/unwind and update display */
     void handleWinds(Int32 numWinds = 0);
+    /** seek by frames and update display */
+    void handleSeek(Int32 numFrames);
     /** toggle Time Machine mode */
     void handleToggle();
 
@@ -79,6 +83,7 @@ class TimeMachineDialog : public Dialog
     StaticTextWidget* myCurrentIdxWidget;
     StaticTextWidget* myLastIdxWidget;
     StaticTextWidget* myMessageWidget;
+    StaticTextWidget* myMemoryWidget;
 
     Int32 _enterWinds;
 
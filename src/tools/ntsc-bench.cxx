@@ -0,0 +1,166 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+/**
+  Checks the vectorized kernels of the Blargg NTSC filter against the scalar
+  reference code (the output must be identical, pixel by pixel), and
+  benchmarks both, single threaded and using a thread pool.
+
+  The filter always produces 565 pixels per TIA line; scaling to the window
+  (e.g. 1080p) is done by the video hardware afterwards, so the benchmark
+  renders full 160 x 262 TIA frames.
+
+  Build from the top-level directory with:
+
+    g++ -O2 -std=c++14 -DBSPF_UNIX -pthread -Isrc/common -Isrc/common/tv_filters \
+      -Isrc/emucore src/tools/ntsc-bench.cxx src/common/tv_filters/AtariNTSC.cxx \
+      src/common/ThreadPool.cxx -o ntsc-bench
+
+  (add e.g. -mavx2 to check and benchmark the AVX2 kernels)
+*/
+
+#include <chrono>
+#include <cstdlib>
+
+#include "bspf.hxx"
+#include "AtariNTSC.hxx"
+#include "ThreadPool.hxx"
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration;
+
+namespace {
+  constexpr uInt32 WIDTH = 160;
+  constexpr uInt32 HEIGHT = 262;
+  constexpr uInt32 OUT_WIDTH = AtariNTSC::outWidth(WIDTH);
+
+  // A frame of random colors, with runs of equal colors like on the TIA
+  void randomFrame(uInt8* frame)
+  {
+    uInt8 color = 0;
+    for(uInt32 i = 0; i < WIDTH * HEIGHT; ++i)
+    {
+      if(std::rand() % 4 == 0)
+        color = uInt8(std::rand());
+      frame[i] = color;
+    }
+  }
+
+  bool compare(AtariNTSC& ntsc, const uInt8* frame, bool phosphor)
+  {
+    vector<uInt32> reference(OUT_WIDTH * HEIGHT), simd(OUT_WIDTH * HEIGHT);
+    vector<uInt32> referencePrev(OUT_WIDTH * HEIGHT, 0x00404040),
+                   simdPrev(OUT_WIDTH * HEIGHT, 0x00404040);
+
+    ntsc.enableSIMD(false);
+    ntsc.render(frame, WIDTH, HEIGHT, reference.data(), OUT_WIDTH * 4,
+                phosphor ? referencePrev.data() : nullptr);
+    ntsc.enableSIMD(true);
+    ntsc.render(frame, WIDTH, HEIGHT, simd.data(), OUT_WIDTH * 4,
+                phosphor ? simdPrev.data() : nullptr);
+
+    for(uInt32 i = 0; i < OUT_WIDTH * HEIGHT; ++i)
+    {
+      if(reference[i] != simd[i] || referencePrev[i] != simdPrev[i])
+      {
+        cout << "MISMATCH at pixel " << i % OUT_WIDTH << ", line " << i / OUT_WIDTH
+             << (phosphor ? " (phosphor)" : "") << endl;
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void benchmark(AtariNTSC& ntsc, const uInt8* frame, bool simd, uInt32 threads,
+                 uInt32 frames)
+  {
+    vector<uInt32> output(OUT_WIDTH * HEIGHT);
+    ThreadPool pool(threads);
+
+    ntsc.enableSIMD(simd);
+    ntsc.setThreadPool(&pool);
+
+    const auto start = high_resolution_clock::now();
+    for(uInt32 i = 0; i < frames; ++i)
+      ntsc.render(frame, WIDTH, HEIGHT, output.data(), OUT_WIDTH * 4);
+    const duration<double> elapsed = high_resolution_clock::now() - start;
+
+    ntsc.setThreadPool(nullptr);
+
+    cout << (simd ? AtariNTSC::simd() : "scalar") << ", " << threads
+         << (threads > 1 ? " threads: " : " thread:  ")
+         << std::fixed << std::setprecision(0) << frames / elapsed.count()
+         << " frames/s, " << std::setprecision(2)
+         << elapsed.count() * 1e9 / (double(frames) * OUT_WIDTH * HEIGHT)
+         << " ns/pixel" << endl;
+  }
+}
+
+int main(int ac, char* av[])
+{
+  const uInt32 frames = ac > 1 ? uInt32(atoi(av[1])) : 2000;
+
+  std::srand(1);
+
+  uInt8 palette[256 * 3];
+  for(uInt8& c: palette)
+    c = uInt8(std::rand());
+
+  uInt8 phosphorPalette[256][256];
+  for(uInt32 c = 0; c < 256; ++c)
+    for(uInt32 p = 0; p < 256; ++p)
+      phosphorPalette[c][p] = uInt8((c * 3 + p) / 4);
+
+  unique_ptr<uInt8[]> frame = make_unique<uInt8[]>(WIDTH * HEIGHT);
+  AtariNTSC ntsc;
+  ntsc.setPhosphorPalette(phosphorPalette);
+
+  const AtariNTSC::Setup* setups[] = {
+    &AtariNTSC::TV_Composite, &AtariNTSC::TV_SVideo, &AtariNTSC::TV_RGB, &AtariNTSC::TV_Bad
+  };
+
+  cout << "SIMD kernels: " << AtariNTSC::simd() << endl;
+  if(string(AtariNTSC::simd()) != "none")
+  {
+    for(const AtariNTSC::Setup* setup: setups)
+    {
+      ntsc.initialize(*setup, palette);
+
+      for(uInt32 i = 0; i < 10; ++i)
+      {
+        randomFrame(frame.get());
+        if(!compare(ntsc, frame.get(), false) || !compare(ntsc, frame.get(), true))
+          return 1;
+      }
+    }
+    cout << "Output identical to the scalar code" << endl;
+  }
+
+  ntsc.initialize(AtariNTSC::TV_Composite, palette);
+  randomFrame(frame.get());
+
+  for(uInt32 threads: {1, 4})
+  {
+    benchmark(ntsc, frame.get(), false, threads, frames);
+    if(string(AtariNTSC::simd()) != "none")
+      benchmark(ntsc, frame.get(), true, threads, frames);
+  }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2018 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+/**
+  Micro-benchmark of the audio resampling pipeline, measuring the time the
+  resamplers take per output sample (as used in the SDL audio callback),
+  for lanczos_2, lanczos_3 and blep with mono and stereo input.
+
+  Build from the top-level directory with:
+
+    g++ -O2 -std=c++14 -DBSPF_UNIX -Isrc/common -Isrc/common/audio -Isrc/emucore \
+      src/tools/resampler-bench.cxx src/common/audio/LanczosResampler.cxx \
+      src/common/audio/BLEPResampler.cxx src/common/audio/ConvolutionBuffer.cxx src/common/audio/HighPass.cxx \
+      -o resampler-bench
+
+  (add e.g. -mavx to benchmark the AVX kernels)
+*/
+
+#include <chrono>
+#include <cstdlib>
+
+#include "bspf.hxx"
+#include "LanczosResampler.hxx"
+#include "BLEPResampler.hxx"
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration;
+
+namespace {
+  // The TIA sample rate, and the fragment size of the audio queue
+  constexpr uInt32 INPUT_RATE = 31440;
+  constexpr uInt32 INPUT_FRAGMENT = 512;
+  constexpr uInt32 OUTPUT_FRAGMENT = 1024;
+
+  void benchmark(uInt32 kernelParameter, bool stereo, uInt32 outputRate, uInt32 seconds)
+  {
+    // Some noise, changing slowly like the TIA output does
+    const uInt32 channels = stereo ? 2 : 1;
+    unique_ptr<Int16[]> input = make_unique<Int16[]>(INPUT_FRAGMENT * channels);
+    Int16 value = 0;
+    std::srand(1);
+    for(uInt32 i = 0; i < INPUT_FRAGMENT * channels; ++i)
+    {
+      if(std::rand() % 8 == 0)
+        value = Int16(std::rand() % 0x7fff - 0x4000);
+      input[i] = value;
+    }
+
+    const Resampler::Format formatFrom(INPUT_RATE, INPUT_FRAGMENT, stereo);
+    const Resampler::Format formatTo(outputRate, OUTPUT_FRAGMENT, true);
+    const Resampler::NextFragmentCallback callback = [&input]() { return input.get(); };
+
+    // Kernel parameter 0 selects band-limited step synthesis
+    unique_ptr<Resampler> resampler;
+    if(kernelParameter > 0)
+      resampler = make_unique<LanczosResampler>(formatFrom, formatTo, callback, kernelParameter);
+    else
+      resampler = make_unique<BLEPResampler>(formatFrom, formatTo, callback);
+
+    unique_ptr<float[]> output = make_unique<float[]>(OUTPUT_FRAGMENT * 2);
+    const uInt32 fragments = outputRate * seconds / OUTPUT_FRAGMENT;
+    double checksum = 0;
+
+    const auto start = high_resolution_clock::now();
+    for(uInt32 i = 0; i < fragments; ++i)
+    {
+      resampler->fillFragment(output.get(), OUTPUT_FRAGMENT * 2);
+      checksum += output[i % (OUTPUT_FRAGMENT * 2)];
+    }
+    const duration<double> elapsed = high_resolution_clock::now() - start;
+
+    cout << (kernelParameter > 0 ? "lanczos_" + std::to_string(kernelParameter) : string("blep     "))
+         << (stereo ? " stereo" : " mono  ")
+         << " -> " << outputRate << " Hz: "
+         << std::fixed << std::setprecision(2)
+         << elapsed.count() * 1e9 / (double(fragments) * OUTPUT_FRAGMENT) << " ns/sample, "
+         << std::setprecision(0) << seconds / elapsed.count() << "x realtime"
+         << std::setprecision(6) << " (checksum " << checksum << ")" << endl;
+  }
+}
+
+int main(int ac, char* av[])
+{
+  const uInt32 seconds = ac > 1 ? uInt32(atoi(av[1])) : 600;
+
+  for(uInt32 kernelParameter: {2, 3, 0})
+    for(bool stereo: {false, true})
+      for(uInt32 outputRate: {44100, 48000})
+        benchmark(kernelParameter, stereo, outputRate, seconds);
+
+  return 0;
+}